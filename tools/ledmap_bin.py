@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Convert WLED ledmap JSON files (ledmapN.json) to binary ledmaps (ledmapN.bin) and back.
+
+Binary ledmaps are streamed directly into the LED map table and do not need the JSON buffer,
+so large maps load quickly and are not limited by JSON buffer size.
+Upload the resulting file to the WLED file system instead of (or next to) the JSON ledmap;
+ledmapN.bin takes precedence over ledmapN.json.
+
+File layout (little endian, see ledmap_bin_t in wled00/const.h):
+  char[4] "WLMP", uint8 version (1), uint8 encoding, uint16 count, uint16 width, uint16 height,
+  uint8 name length (0-32), name, map data
+  encoding 0 (raw):  uint16 per logical pixel (0xFFFF = no LED)
+  encoding 1 (runs): records of {uint16 first, uint16 count, int16 step}
+
+usage: ledmap_bin.py ledmap.json [-o ledmap.bin] [--encoding auto|raw|runs]
+       ledmap_bin.py ledmap.bin  [-o ledmap.json]
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"WLMP"
+VERSION = 1
+ENC_RAW = 0
+ENC_RUNS = 1
+HEADER = struct.Struct("<4sBBHHHB")
+RUN = struct.Struct("<HHh")
+
+
+def encode_runs(values):
+    """Split map into runs of constant step (serpentine rows, gaps and straight rows compress well)."""
+    runs = []
+    i = 0
+    while i < len(values):
+        first = values[i]
+        step = values[i + 1] - first if i + 1 < len(values) else 0
+        if not -32768 <= step <= 32767:
+            step = 0
+        count = 1
+        while (i + count < len(values) and count < 0xFFFF
+               and values[i + count] == (first + count * step) & 0xFFFF):
+            count += 1
+        runs.append((first, count, step))
+        i += count
+    return b"".join(RUN.pack(*r) for r in runs)
+
+
+def to_bin(doc, encoding):
+    values = [0xFFFF if v < 0 else v for v in doc["map"]]
+    if len(values) > 0xFFFF or any(v > 0xFFFF for v in values):
+        raise ValueError("map too large")
+    name = doc.get("n", "").encode("utf-8")[:32]
+    raw = struct.pack("<%dH" % len(values), *values)
+    runs = encode_runs(values)
+    if encoding == "auto":
+        encoding = "runs" if len(runs) < len(raw) else "raw"
+    enc, data = (ENC_RUNS, runs) if encoding == "runs" else (ENC_RAW, raw)
+    header = HEADER.pack(MAGIC, VERSION, enc, len(values), doc.get("width", 0), doc.get("height", 0), len(name))
+    return header + name + data
+
+
+def from_bin(data):
+    magic, version, enc, count, width, height, name_len = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not a binary ledmap")
+    pos = HEADER.size
+    name = data[pos:pos + name_len].decode("utf-8")
+    pos += name_len
+    if enc == ENC_RAW:
+        values = list(struct.unpack_from("<%dH" % count, data, pos))
+    else:
+        values = []
+        while len(values) < count:
+            first, n, step = RUN.unpack_from(data, pos)
+            pos += RUN.size
+            values.extend((first + k * step) & 0xFFFF for k in range(n))
+        values = values[:count]
+    doc = {}
+    if name:
+        doc["n"] = name
+    if width or height:
+        doc["width"] = width
+        doc["height"] = height
+    doc["map"] = [-1 if v == 0xFFFF else v for v in values]
+    return doc
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert WLED ledmap between JSON and binary format.")
+    parser.add_argument("input", help="ledmapN.json or ledmapN.bin")
+    parser.add_argument("-o", "--output", help="output file (default: input with swapped extension)")
+    parser.add_argument("--encoding", choices=["auto", "raw", "runs"], default="auto",
+                        help="binary encoding (auto picks the smaller one)")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+
+    if data[:4] == MAGIC:
+        out = json.dumps(from_bin(data), separators=(",", ":")).encode("utf-8")
+        ext = ".json"
+    else:
+        out = to_bin(json.loads(data), args.encoding)
+        ext = ".bin"
+
+    output = args.output or args.input.rsplit(".", 1)[0] + ext
+    with open(output, "wb") as f:
+        f.write(out)
+    print("%s: %d bytes (from %d bytes)" % (output, len(out), len(data)))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
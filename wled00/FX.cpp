@@ -5102,106 +5102,171 @@ static const char _data_FX_MODE_2DFRIZZLES[] PROGMEM = "Frizzles@X frequency,Y f
 ///////////////////////////////////////////
 //   2D Cellular Automata Game of life   //
 ///////////////////////////////////////////
-typedef struct ColorCount {
-  CRGB color;
-  int8_t count;
-} colorCount;
+// cellular automaton engine: generations are kept as bit planes (one bit per cell, rows padded to 32 bit words)
+// neighbour counts are calculated for 32 cells at once using bit sliced adders, everything wraps around
+typedef struct CellularAutomaton {
+  uint16_t cols, rows;
+  uint16_t wordsPerRow;
+  uint16_t crc[2];      // CRCs of previous generations (repetition detection)
+  uint8_t  current;     // plane holding current generation
+  // followed by 2 bit planes and one color (palette) index per cell
+} automaton_t;
+
+// adds a word of 1 bit values to 32 bit sliced counters (s[0] holds bit 0 of all 32 counts, etc.)
+static inline void caAdd(uint32_t v, uint32_t s[4]) {
+  uint32_t c0 = s[0] & v;  s[0] ^= v;
+  uint32_t c1 = s[1] & c0; s[1] ^= c0;
+  uint32_t c2 = s[2] & c1; s[2] ^= c1;
+  s[3] |= c2;
+}
+
+// west neighbours of word w (bit x holds cell x-1)
+static inline uint32_t caWest(const uint32_t *row, unsigned w, unsigned cols) {
+  uint32_t carry = w ? row[w-1] >> 31 : (row[(cols-1) >> 5] >> ((cols-1) & 31)) & 1;
+  return (row[w] << 1) | carry;
+}
+
+// east neighbours of word w (bit x holds cell x+1), relies on padding bits being 0
+static inline uint32_t caEast(const uint32_t *row, unsigned w, unsigned wordsPerRow, unsigned cols) {
+  uint32_t v = row[w] >> 1;
+  if (w + 1 < wordsPerRow) v |= row[w+1] << 31;
+  else                     v |= (row[0] & 1) << ((cols-1) & 31);
+  return v;
+}
+
+// bit sliced neighbour count for 32 cells of word w in row y
+static void caCountNeighbours(const uint32_t *plane, unsigned w, unsigned y, const automaton_t *ca, uint32_t s[4]) {
+  const unsigned wpr = ca->wordsPerRow;
+  const uint32_t *rows[3] = { plane + ((y + ca->rows - 1) % ca->rows) * wpr, plane + y * wpr, plane + ((y + 1) % ca->rows) * wpr };
+  s[0] = s[1] = s[2] = s[3] = 0;
+  for (unsigned i = 0; i < 3; i++) {
+    caAdd(caWest(rows[i], w, ca->cols), s);
+    if (i != 1) caAdd(rows[i][w], s);
+    caAdd(caEast(rows[i], w, wpr, ca->cols), s);
+  }
+}
+
+// mask of cells having exactly n neighbours
+static inline uint32_t caCountIs(const uint32_t s[4], unsigned n) {
+  return (n & 1 ? s[0] : ~s[0]) & (n & 2 ? s[1] : ~s[1]) & (n & 4 ? s[2] : ~s[2]) & (n & 8 ? s[3] : ~s[3]);
+}
+
+static inline bool caIsAlive(const uint32_t *plane, const automaton_t *ca, unsigned x, unsigned y) {
+  return (plane[y * ca->wordsPerRow + (x >> 5)] >> (x & 31)) & 1;
+}
+
+// most frequent color among living neighbours (first found if all differ)
+static uint8_t caDominantColor(const uint32_t *plane, const uint8_t *colorIdx, const automaton_t *ca, unsigned x, unsigned y) {
+  uint8_t found[8];
+  unsigned n = 0;
+  for (int i = -1; i <= 1; i++) for (int j = -1; j <= 1; j++) {
+    if (i == 0 && j == 0) continue;
+    unsigned xx = (x + ca->cols + i) % ca->cols;
+    unsigned yy = (y + ca->rows + j) % ca->rows;
+    if (caIsAlive(plane, ca, xx, yy)) found[n++] = colorIdx[yy * ca->cols + xx];
+  }
+  unsigned best = 0, bestCount = 0;
+  for (unsigned i = 0; i < n; i++) {
+    unsigned count = 0;
+    for (unsigned k = 0; k < n; k++) if (found[k] == found[i]) count++;
+    if (count > bestCount) { best = i; bestCount = count; }
+  }
+  return n ? found[best] : hw_random8();
+}
 
 uint16_t mode_2Dgameoflife(void) { // Written by Ewoud Wijma, inspired by https://natureofcode.com/book/chapter-7-cellular-automata/ and https://github.com/DougHaber/nlife-color
   if (!strip.isMatrix || !SEGMENT.is2D()) return mode_static(); // not a 2D set-up
 
-  const int cols = SEG_W;
-  const int rows = SEG_H;
-  const unsigned dataSize = sizeof(CRGB) * SEGMENT.length();  // using width*height prevents reallocation if mirroring is enabled
-  const int crcBufferLen = 2; //(SEGMENT.width() + SEGMENT.height())*71/100; // roughly sqrt(2)/2 for better repetition detection (Ewowi)
+  const unsigned cols = SEG_W;
+  const unsigned rows = SEG_H;
+  const unsigned wordsPerRow = (cols + 31) / 32;
+  const unsigned planeSize = wordsPerRow * rows; // in words
+  const unsigned dataSize = sizeof(automaton_t) + 2 * planeSize * sizeof(uint32_t) + cols * rows;
+  const unsigned crcBufferLen = 2;
 
-  if (!SEGENV.allocateData(dataSize + sizeof(uint16_t)*crcBufferLen)) return mode_static(); //allocation failed
-  CRGB *prevLeds = reinterpret_cast<CRGB*>(SEGENV.data);
-  uint16_t *crcBuffer = reinterpret_cast<uint16_t*>(SEGENV.data + dataSize); 
+  if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
+  automaton_t *ca  = reinterpret_cast<automaton_t*>(SEGENV.data);
+  uint32_t *planes = reinterpret_cast<uint32_t*>(SEGENV.data + sizeof(automaton_t));
+  uint8_t *colorIdx = reinterpret_cast<uint8_t*>(planes + 2 * planeSize);
 
-  CRGB backgroundColor = SEGCOLOR(1);
+  const uint32_t bgc = SEGCOLOR(1);
 
-  if (SEGENV.call == 0 || strip.now - SEGMENT.step > 3000) {
+  if (SEGENV.call == 0 || strip.now - SEGMENT.step > 3000 || ca->cols != cols || ca->rows != rows) {
     SEGENV.step = strip.now;
     SEGENV.aux0 = 0;
-
-    //give the leds random state and colors (based on intensity, colors from palette or all posible colors are chosen)
-    for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) {
-      unsigned state = hw_random8()%2;
-      if (state == 0)
-        SEGMENT.setPixelColorXY(x,y, backgroundColor);
-      else
-        SEGMENT.setPixelColorXY(x,y, SEGMENT.color_from_palette(hw_random8(), false, PALETTE_SOLID_WRAP, 255));
+    ca->cols = cols;
+    ca->rows = rows;
+    ca->wordsPerRow = wordsPerRow;
+    ca->current = 0;
+    memset(ca->crc, 0, sizeof(ca->crc));
+    memset(planes, 0, 2 * planeSize * sizeof(uint32_t));
+
+    //give the leds random state and colors (colors from palette)
+    for (unsigned y = 0; y < rows; y++) for (unsigned x = 0; x < cols; x++) {
+      if (hw_random8() & 1) {
+        planes[y * wordsPerRow + (x >> 5)] |= 1UL << (x & 31);
+        colorIdx[y * cols + x] = hw_random8();
+        SEGMENT.setPixelColorXY(x, y, SEGMENT.color_from_palette(colorIdx[y * cols + x], false, PALETTE_SOLID_WRAP, 255));
+      } else
+        SEGMENT.setPixelColorXY(x, y, bgc);
     }
-
-    for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) prevLeds[XY(x,y)] = CRGB::Black;
-    memset(crcBuffer, 0, sizeof(uint16_t)*crcBufferLen);
+    return FRAMETIME;
   } else if (strip.now - SEGENV.step < FRAMETIME_FIXED * (uint32_t)map(SEGMENT.speed,0,255,64,4)) {
     // update only when appropriate time passes (in 42 FPS slots)
     return FRAMETIME;
   }
 
-  //copy previous leds (save previous generation)
-  //NOTE: using lossy getPixelColor() is a benefit as endlessly repeating patterns will eventually fade out causing a reset
-  for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) prevLeds[XY(x,y)] = SEGMENT.getPixelColorXY(x,y);
-
-  //calculate new leds
-  for (int x = 0; x < cols; x++) for (int y = 0; y < rows; y++) {
-
-    colorCount colorsCount[9]; // count the different colors in the 3*3 matrix
-    for (int i=0; i<9; i++) colorsCount[i] = {backgroundColor, 0}; // init colorsCount
-
-    // iterate through neighbors and count them and their different colors
-    int neighbors = 0;
-    for (int i = -1; i <= 1; i++) for (int j = -1; j <= 1; j++) { // iterate through 3*3 matrix
-      if (i==0 && j==0) continue; // ignore itself
-      // wrap around segment
-      int xx = x+i, yy = y+j;
-      if (x+i < 0) xx = cols-1; else if (x+i >= cols) xx = 0;
-      if (y+j < 0) yy = rows-1; else if (y+j >= rows) yy = 0;
-
-      unsigned xy = XY(xx, yy); // previous cell xy to check
-      // count different neighbours and colors
-      if (prevLeds[xy] != backgroundColor) {
-        neighbors++;
-        bool colorFound = false;
-        int k;
-        for (k=0; k<9 && colorsCount[i].count != 0; k++)
-          if (colorsCount[k].color == prevLeds[xy]) {
-            colorsCount[k].count++;
-            colorFound = true;
-          }
-        if (!colorFound) colorsCount[k] = {prevLeds[xy], 1}; //add new color found in the array
-      }
-    } // i,j
-
-    // Rules of Life
-    uint32_t col = uint32_t(prevLeds[XY(x,y)]) & 0x00FFFFFF;  // uint32_t operator returns RGBA, we want RGBW -> cut off "alpha" byte
-    uint32_t bgc = RGBW32(backgroundColor.r, backgroundColor.g, backgroundColor.b, 0);
-    if      ((col != bgc) && (neighbors <  2)) SEGMENT.setPixelColorXY(x,y, bgc); // Loneliness
-    else if ((col != bgc) && (neighbors >  3)) SEGMENT.setPixelColorXY(x,y, bgc); // Overpopulation
-    else if ((col == bgc) && (neighbors == 3)) {                                  // Reproduction
-      // find dominant color and assign it to a cell
-      colorCount dominantColorCount = {backgroundColor, 0};
-      for (int i=0; i<9 && colorsCount[i].count != 0; i++)
-        if (colorsCount[i].count > dominantColorCount.count) dominantColorCount = colorsCount[i];
-      // assign the dominant color w/ a bit of randomness to avoid "gliders"
-      if (dominantColorCount.count > 0 && hw_random8(128)) SEGMENT.setPixelColorXY(x,y, dominantColorCount.color);
-    } else if ((col == bgc) && (neighbors == 2) && !hw_random8(128)) {               // Mutation
-      SEGMENT.setPixelColorXY(x,y, SEGMENT.color_from_palette(hw_random8(), false, PALETTE_SOLID_WRAP, 255));
-    }
-    // else do nothing!
-  } //x,y
-
-  // calculate CRC16 of leds
-  uint16_t crc = crc16((const unsigned char*)prevLeds, dataSize);
+  const uint32_t *cur = planes + ca->current * planeSize;
+  uint32_t *next      = planes + (ca->current ^ 1) * planeSize;
+
+  //calculate new generation, 32 cells at a time
+  for (unsigned y = 0; y < rows; y++) for (unsigned w = 0; w < wordsPerRow; w++) {
+    uint32_t s[4];
+    caCountNeighbours(cur, w, y, ca, s);
+    const uint32_t valid = (w == wordsPerRow-1 && (cols & 31)) ? (1UL << (cols & 31)) - 1 : 0xFFFFFFFFUL;
+    const uint32_t alive = cur[y * wordsPerRow + w];
+    const uint32_t two   = caCountIs(s, 2);
+    const uint32_t three = caCountIs(s, 3);
+    uint32_t nextWord = alive & (two | three);   // Loneliness (<2) and Overpopulation (>3) kill
+    uint32_t born     = ~alive & three & valid;  // Reproduction
+    uint32_t mutate   = ~alive & two & valid;    // Mutation
+    while (born) {
+      unsigned b = __builtin_ctz(born);
+      born &= born - 1;
+      if (!hw_random8(128)) continue; // a bit of randomness to avoid "gliders"
+      unsigned x = w * 32 + b;
+      colorIdx[y * cols + x] = caDominantColor(cur, colorIdx, ca, x, y); // dominant color of neighbours
+      nextWord |= 1UL << b;
+    }
+    while (mutate) {
+      unsigned b = __builtin_ctz(mutate);
+      mutate &= mutate - 1;
+      if (hw_random8(128)) continue;
+      colorIdx[y * cols + w * 32 + b] = hw_random8();
+      nextWord |= 1UL << b;
+    }
+    next[y * wordsPerRow + w] = nextWord;
+    // draw only changed cells
+    uint32_t changed = nextWord ^ alive;
+    while (changed) {
+      unsigned b = __builtin_ctz(changed);
+      changed &= changed - 1;
+      unsigned x = w * 32 + b;
+      if ((nextWord >> b) & 1) SEGMENT.setPixelColorXY(x, y, SEGMENT.color_from_palette(colorIdx[y * cols + x], false, PALETTE_SOLID_WRAP, 255));
+      else                     SEGMENT.setPixelColorXY(x, y, bgc);
+    }
+  }
+  ca->current ^= 1;
+
+  // calculate CRC16 of new generation
+  uint16_t crc = crc16((const unsigned char*)next, planeSize * sizeof(uint32_t));
   // check if we had same CRC and reset if needed
   bool repetition = false;
-  for (int i=0; i<crcBufferLen && !repetition; i++) repetition = (crc == crcBuffer[i]); // (Ewowi)
+  for (unsigned i = 0; i < crcBufferLen && !repetition; i++) repetition = (crc == ca->crc[i]); // (Ewowi)
   // same CRC would mean image did not change or was repeating itself
   if (!repetition) SEGENV.step = strip.now; //if no repetition avoid reset
   // remember CRCs across frames
-  crcBuffer[SEGENV.aux0] = crc;
+  ca->crc[SEGENV.aux0] = crc;
   ++SEGENV.aux0 %= crcBufferLen;
 
   return FRAMETIME;
@@ -6854,12 +6919,14 @@ uint16_t mode_blurz(void) {                    // Blurz. By Andrew Tuline.
     ++(SEGENV.aux0) %= 16; // make sure it doesn't cross 16
 
     SEGENV.step = 1;
-    SEGMENT.blur(SEGMENT.intensity); // note: blur > 210 results in a alternating pattern, this could be fixed by mapping but some may like it (very old bug)
+    const uint8_t kernel = std::min(SEGMENT.custom3 / 11, BLUR_GAUSS); // 0-10: smear, 11-21: box, 22-31: gauss
+    if (kernel == BLUR_SMEAR) SEGMENT.blur(SEGMENT.intensity); // note: blur > 210 results in a alternating pattern, this could be fixed by mapping but some may like it (very old bug)
+    else if (SEGMENT.intensity) SEGMENT.blur(1 + SEGMENT.intensity / 86, false, kernel); // radius 1-3
   }
 
   return FRAMETIME;
 } // mode_blurz()
-static const char _data_FX_MODE_BLURZ[] PROGMEM = "Blurz@Fade rate,Blur;!,Color mix;!;1f;m12=0,si=0"; // Pixels, Beatsin
+static const char _data_FX_MODE_BLURZ[] PROGMEM = "Blurz@Fade rate,Blur,,,Kernel;!,Color mix;!;1f;m12=0,si=0,c3=0"; // Pixels, Beatsin
 
 
 /////////////////////////
@@ -68,6 +68,13 @@ extern byte realtimeMode;           // used in getMappedPixelIndex()
 #endif
 #define FPS_CALC_SHIFT 7 // bit shift for fixed point math
 
+// frame budget scheduler: when effects take longer than their share of frame time the costliest segments are updated less often
+#ifndef FRAME_BUDGET_PCT
+#define FRAME_BUDGET_PCT 75        // share of frame time (in %) effects may use, rest is left for compositing and show()
+#endif
+#define FRAME_BUDGET_MAX_THROTTLE 7 // max. number of frames a throttled segment skips between updates
+#define FRAME_BUDGET_HOLD 8         // number of frames between scheduler decisions
+
 /* each segment uses 82 bytes of SRAM memory, so if you're application fails because of
   insufficient memory, decreasing MAX_NUM_SEGMENTS may help */
 #ifdef ESP8266
@@ -131,6 +138,14 @@ extern byte realtimeMode;           // used in getMappedPixelIndex()
 #define REVERSE      (uint16_t)0x0002
 #define SELECTED     (uint16_t)0x0001
 
+// blur kernels (see Segment::blur() and Segment::blur2D())
+#define BLUR_SMEAR   0 // FastLED style blur, amount 1-255 (smear keeps source pixel at full brightness)
+#define BLUR_BOX     1 // moving average, radius 1-3
+#define BLUR_GAUSS   2 // repeated [1 2 1] binomial passes, radius (number of passes) 1-3
+#ifndef BLUR_ROW_KEEP
+#define BLUR_ROW_KEEP 512 // blur scratch rows up to this many pixels are kept between calls, larger ones are freed after use
+#endif
+
 #define FX_MODE_STATIC                   0
 #define FX_MODE_BLINK                    1
 #define FX_MODE_BREATH                   2
@@ -333,6 +348,106 @@ typedef enum mapping1D2D {
   M12_sPinwheel = 4
 } mapping1D2D_t;
 
+// segment layer blend modes (used when compositing segments into strip buffer)
+typedef enum blendMode {
+  BLEND_MODE_NORMAL = 0,
+  BLEND_MODE_ADD = 1,
+  BLEND_MODE_MULTIPLY = 2,
+  BLEND_MODE_SCREEN = 3,
+  BLEND_MODE_LIGHTEN = 4,
+  BLEND_MODE_DARKEN = 5,
+  BLEND_MODE_COUNT
+} blendmode_t;
+
+// effect transition styles (used when old and new effect are rendered into separate buffers)
+typedef enum blendingStyle {
+  BLEND_STYLE_FADE = 0,
+  BLEND_STYLE_WIPE = 1,
+  BLEND_STYLE_PUSH = 2,
+  BLEND_STYLE_DISSOLVE = 3,
+  BLEND_STYLE_COUNT
+} blendingstyle_t;
+
+// guards segment buffers (effect data arena, pixel buffers) against concurrent access from web server and
+// realtime (UDP) tasks, must be taken after the state lock if both are needed
+#ifdef ARDUINO_ARCH_ESP32
+class SegmentBufferLock {
+  public:
+    SegmentBufferLock();
+    ~SegmentBufferLock();
+    SegmentBufferLock(const SegmentBufferLock&) = delete;
+    SegmentBufferLock& operator=(const SegmentBufferLock&) = delete;
+};
+#else
+class SegmentBufferLock {
+  public:
+    inline SegmentBufferLock() {}
+    SegmentBufferLock(const SegmentBufferLock&) = delete;
+    SegmentBufferLock& operator=(const SegmentBufferLock&) = delete;
+};
+#endif
+
+/* Compacting arena for effect data (SEGENV.data)
+  Blocks are referenced by handles; pointers obtained with get() stay valid until the next compact(),
+  which runs between frames in WS2812FX::service() and moves all blocks to the start of the arena.
+  Segments are also copied and destroyed by the web server task, so the arena is only used while holding
+  the segment buffer lock (see FX_fcn.cpp). Adjacent free blocks are merged when allocating.
+  The arena is kept small (it is reserved permanently), blocks that do not fit are allocated on the heap
+  and are never moved. */
+#ifndef WLED_DATA_ARENA_SIZE
+  #ifdef ESP8266
+    #define WLED_DATA_ARENA_SIZE 1024
+  #else
+    #define WLED_DATA_ARENA_SIZE 4096
+  #endif
+#endif
+#define DATA_ARENA_HANDLES (2*MAX_NUM_SEGMENTS) // effect data of each segment plus a copy for mode blending
+#define DATA_ARENA_SIZE    (WLED_DATA_ARENA_SIZE + DATA_ARENA_HANDLES*4) // plus block headers
+
+class DataArena {
+  public:
+    typedef uint8_t handle_t; // 0 is an invalid handle
+
+    DataArena() : _buf(nullptr), _size(0), _top(0), _used(0), _heapUsed(0), _compactions(0), _failed(0), _fragmented(false) {
+      memset(_slots, 0, sizeof(_slots));
+      memset(_onHeap, 0, sizeof(_onHeap));
+    }
+
+    bool     begin(size_t size);            // allocates the arena buffer (once)
+    handle_t alloc(size_t len);             // falls back to heap if there is no contiguous space, returns 0 if that fails too
+    void     release(handle_t h);
+    bool     compact();                     // returns true if blocks were moved (pointers must be refreshed)
+    inline byte *get(handle_t h) const      { return h < DATA_ARENA_HANDLES ? _slots[h] : nullptr; }
+
+    // statistics
+    inline size_t   getSize() const         { return _size; }
+    inline size_t   getUsed() const         { return _used; }  // including block headers
+    inline size_t   getFree() const         { return _size - _used; }
+    inline size_t   getHeapUsed() const     { return _heapUsed; } // blocks that did not fit into the arena
+    inline uint32_t getCompactions() const  { return _compactions; }
+    inline uint32_t getFailed() const       { return _failed; } // allocations that failed due to fragmentation
+    size_t   getLargestFree() const;        // largest contiguous free block
+    unsigned getHoles() const;              // number of free blocks below top
+
+  private:
+    // each block is preceded by a header, blocks are 4 byte aligned
+    typedef struct BlockHeader {
+      uint32_t len    : 24;                 // payload length
+      uint32_t handle :  8;                 // owning handle (0 = free block)
+    } blockhdr_t;
+
+    byte    *_buf;
+    size_t   _size;
+    size_t   _top;                          // end of last block
+    size_t   _used;
+    size_t   _heapUsed;
+    uint32_t _compactions;
+    uint32_t _failed;
+    bool     _fragmented;                   // there are free blocks below top
+    byte    *_slots[DATA_ARENA_HANDLES];    // handle -> payload pointer
+    bool     _onHeap[DATA_ARENA_HANDLES];   // block was allocated on the heap (arena was full)
+};
+
 // segment, 80 bytes
 typedef struct Segment {
   public:
@@ -362,6 +477,7 @@ typedef struct Segment {
     };
     uint8_t  grouping, spacing;
     uint8_t  opacity;
+    uint8_t  blendMode;           // layer blend mode (blendmode_t), opacity is used as layer alpha
     uint32_t colors[NUM_COLORS];
     uint8_t  cct;                 //0==1900K, 255==10091K
     uint8_t  custom1, custom2;    // custom FX parameters/sliders
@@ -383,6 +499,9 @@ typedef struct Segment {
     uint16_t aux0;  // custom var
     uint16_t aux1;  // custom var
     byte     *data; // effect data pointer
+    uint32_t *pixels; // effect pixel buffer in virtual coordinates (unscaled RGBW), nullptr if segment draws directly to the strip
+    uint32_t cost;     // moving average of effect run time in us
+    uint8_t  throttle; // number of frames skipped between effect updates (set by frame budget scheduler)
     static uint16_t maxWidth, maxHeight;  // these define matrix width & height (max. segment dimensions)
 
     typedef struct TemporarySegmentData {
@@ -403,9 +522,15 @@ typedef struct Segment {
       uint32_t _callT;
       uint8_t *_dataT;
       unsigned _dataLenT;
+      DataArena::handle_t _dataHandleT;
+      uint32_t *_pixelsT;             // pixel buffer of previous effect (only in transition, nullptr if shared with new effect)
+      unsigned _pixelsLenT;
       TemporarySegmentData()
         : _dataT(nullptr) // just in case...
         , _dataLenT(0)
+        , _dataHandleT(0)
+        , _pixelsT(nullptr)
+        , _pixelsLenT(0)
       {}
     } tmpsegd_t;
 
@@ -421,8 +546,37 @@ typedef struct Segment {
       };
     };
     uint8_t         _default_palette;  // palette number that gets assigned to pal0
+    DataArena::handle_t _dataHandle;   // handle of effect data in _dataArena (data is a cached pointer)
     unsigned        _dataLen;
+    unsigned        _pixelsLen;               // number of pixels allocated in pixels[]
+
+    // palette of this segment expanded to 256 entries (rebuilt only when palette content or blend type changes)
+    typedef struct PaletteCache {
+      CRGBPalette16 pal;                      // palette the LUT was built from
+      uint32_t      lut[256];                 // interpolated palette colors (RGB, W is taken from segment color)
+      uint32_t      colors[NUM_COLORS];       // segment colors the palette was loaded with (palettes 2-5)
+      uint8_t       id;                       // palette id the palette was loaded for
+      uint8_t       defaultId;                // _default_palette the palette was loaded for
+      float         gamma;                    // color gamma the palette was loaded with (palettes 2-5 are gamma corrected)
+      bool          noBlend;                  // LUT built without interpolation (strip.paletteBlend == 3)
+      bool          valid;
+    } palcache_t;
+    palcache_t     *_palCache;                // nullptr if not allocated (interpolation is used)
+
+    // geometry (bounds, grouping, spacing, reverse, transpose) compiled into strides by _compileGeometry()
+    // XY: physical X = orgX + x*xX + y*yX, Y = orgY + x*xY + y*yY (relative to start/startY, first pixel of a group)
+    // 1D: strip index = org + i*step (first pixel of a group, before offset and mirroring)
+    typedef struct {
+      int16_t orgX, orgY;
+      int16_t xX, xY;
+      int16_t yX, yY;
+      int     org;
+      int16_t step;
+    } geom_t;
+    geom_t          _geom;
+
     static unsigned _usedSegmentData;
+    static DataArena _dataArena;              // effect data of all segments
     static uint8_t  _segBri;                  // brightness of segment for current effect
     static unsigned _vLength;                 // 1D dimension used for current effect
     static unsigned _vWidth, _vHeight;        // 2D dimensions used for current effect
@@ -434,6 +588,8 @@ typedef struct Segment {
     static uint16_t _lastPaletteChange;       // last random palette change time in millis()/1000
     static uint16_t _lastPaletteBlend;        // blend palette according to set Transition Delay in millis()%0xFFFF
     static uint16_t _transitionprogress;      // current transition progress 0 - 0xFFFF
+    static uint32_t *_blurRow;                // scratch row shared by all blur kernels (2x line for gauss, +1x line for unbuffered segments)
+    static unsigned _blurRowLen;
     #ifndef WLED_DISABLE_MODE_BLEND
     static bool          _modeBlend;          // mode/effect blending semaphore
     #endif
@@ -460,7 +616,14 @@ typedef struct Segment {
       {}
     } *_t;
 
+    void _compileGeometry();                                      // update _geom (call whenever _vWidth/_vHeight/_vLength are updated)
     [[gnu::hot]] void _setPixelColorXY_raw(int& x, int& y, uint32_t& col); // set pixel without mapping (internal use only)
+    [[gnu::hot]] void _expandPixel(int i, uint32_t col);          // expand virtual 1D pixel onto the strip (grouping, reverse, mirror, offset)
+    [[gnu::hot]] void _expandPixelXY(int x, int y, uint32_t col); // expand virtual 2D pixel onto the strip (reverse, transpose, grouping)
+    [[gnu::hot]] void _setPixelSpanXY(int y, int x0, int x1, uint32_t col, const uint32_t *cols); // write a run of pixels in a row (cols may be nullptr)
+    static uint32_t *_getBlurRow(unsigned len);
+    static void _freeBlurRow(bool force = false);
+    [[gnu::hot]] static void _blurLine(uint32_t *dst, unsigned stride, uint32_t *src, unsigned len, uint8_t kernel, uint8_t amount, bool smear); // src must hold 2*len pixels for BLUR_GAUSS
 
   public:
 
@@ -476,6 +639,7 @@ typedef struct Segment {
       grouping(1),
       spacing(0),
       opacity(255),
+      blendMode(BLEND_MODE_NORMAL),
       colors{DEFAULT_COLOR,BLACK,BLACK},
       cct(127),
       custom1(DEFAULT_C1),
@@ -493,11 +657,18 @@ typedef struct Segment {
       aux0(0),
       aux1(0),
       data(nullptr),
+      pixels(nullptr),
+      cost(0),
+      throttle(0),
       _capabilities(0),
       _default_palette(0),
+      _dataHandle(0),
       _dataLen(0),
+      _pixelsLen(0),
+      _palCache(nullptr),
       _t(nullptr)
     {
+      _compileGeometry();
       #ifdef WLED_DEBUG
       //Serial.printf("-- Creating segment: %p\n", this);
       #endif
@@ -506,9 +677,11 @@ typedef struct Segment {
     Segment(uint16_t sStartX, uint16_t sStopX, uint16_t sStartY, uint16_t sStopY) : Segment(sStartX, sStopX) {
       startY = sStartY;
       stopY  = sStopY;
+      _compileGeometry();
     }
 
-    Segment(const Segment &orig); // copy constructor
+    Segment(const Segment &orig) : Segment(orig, true) {} // copy constructor
+    Segment(const Segment &orig, bool withBuffers); // copy without effect data and pixels if !withBuffers (for comparison)
     Segment(Segment &&orig) noexcept; // move constructor
 
     ~Segment() {
@@ -521,18 +694,23 @@ typedef struct Segment {
       if (name) { delete[] name; name = nullptr; }
       stopTransition();
       deallocateData();
+      deallocatePixels();
+      if (_palCache) { free(_palCache); _palCache = nullptr; }
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
     Segment& operator= (Segment &&orig) noexcept; // move assignment
 
 #ifdef WLED_DEBUG
-    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
+    size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (pixels?_pixelsLen*sizeof(uint32_t):0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
 #endif
 
     inline bool     getOption(uint8_t n) const { return ((options >> n) & 0x01); }
     inline bool     isSelected()         const { return selected; }
     inline bool     isInTransition()     const { return _t != nullptr; }
+    #ifndef WLED_DISABLE_MODE_BLEND
+    inline bool     isTransitionBuffered() const { return _t != nullptr && _t->_segT._pixelsT != nullptr; } // old effect renders into its own buffer
+    #endif
     inline bool     isActive()           const { return stop > start; }
     inline bool     is2D()               const { return (width()>1 && height()>1); }
     inline bool     hasRGB()             const { return _isRGB; }
@@ -547,6 +725,7 @@ typedef struct Segment {
 
     inline static unsigned getUsedSegmentData()            { return Segment::_usedSegmentData; }
     inline static void     addUsedSegmentData(int len)     { Segment::_usedSegmentData += len; }
+    inline static DataArena &getDataArena()                { return Segment::_dataArena; }
     #ifndef WLED_DISABLE_MODE_BLEND
     inline static void     modeBlend(bool blend)           { _modeBlend = blend; }
     #endif
@@ -573,7 +752,12 @@ typedef struct Segment {
     inline uint16_t dataSize() const { return _dataLen; }
     bool allocateData(size_t len);  // allocates effect data buffer in heap and clears it
     void deallocateData();          // deallocates (frees) effect data buffer from heap
+    void refreshData();             // updates data pointers after effect data has been moved by DataArena::compact()
     void resetIfRequired();         // sets all SEGENV variables to 0 and clears data buffer
+    bool allocatePixels();          // (re)allocates pixel buffer to match virtual dimensions (keeps content if size is unchanged)
+    void deallocatePixels();        // frees pixel buffer, segment will draw directly to the strip
+    void updatePaletteCache();      // loads _currentPalette (from cache if unchanged) and rebuilds palette LUT if needed
+    void pushPixels();              // expands pixel buffer onto the strip (compositing pass, called from WS2812FX::service())
     /**
       * Flags that before the next effect is calculated,
       * the internal segment state should be reset.
@@ -610,7 +794,7 @@ typedef struct Segment {
     #endif
     [[gnu::hot]] uint32_t getPixelColor(int i) const;
     // 1D support functions (some implement 2D as well)
-    void blur(uint8_t, bool smear = false);
+    void blur(uint8_t, bool smear = false, uint8_t kernel = BLUR_SMEAR); // blur amount (BLUR_SMEAR) or radius (BLUR_BOX, BLUR_GAUSS)
     void fill(uint32_t c);
     void fade_out(uint8_t r);
     void fadeToBlackBy(uint8_t fadeBy);
@@ -648,6 +832,8 @@ typedef struct Segment {
     inline void setPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0) { setPixelColorXY(x, y, RGBW32(r,g,b,w)); }
     inline void setPixelColorXY(int x, int y, CRGB c)                             { setPixelColorXY(x, y, RGBW32(c.r,c.g,c.b,0)); }
     inline void setPixelColorXY(unsigned x, unsigned y, CRGB c)                   { setPixelColorXY(int(x), int(y), RGBW32(c.r,c.g,c.b,0)); }
+    inline void setPixelSpanXY(int y, int x0, int x1, uint32_t c)                 { _setPixelSpanXY(y, x0, x1, c, nullptr); } // set pixels x0..x1 (inclusive) in row y
+    inline void setPixelSpanXY(int y, int x0, int x1, const uint32_t *c)          { if (c) _setPixelSpanXY(y, x0, x1, 0, c); } // c[0] is the color of pixel x0
     #ifdef WLED_USE_AA_PIXELS
     void setPixelColorXY(float x, float y, uint32_t c, bool aa = true);
     inline void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColorXY(x, y, RGBW32(r,g,b,w), aa); }
@@ -661,8 +847,8 @@ typedef struct Segment {
     inline void addPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0, bool preserveCR = true) { addPixelColorXY(x, y, RGBW32(r,g,b,w), preserveCR); }
     inline void addPixelColorXY(int x, int y, CRGB c, bool preserveCR = true)                             { addPixelColorXY(x, y, RGBW32(c.r,c.g,c.b,0), preserveCR); }
     inline void fadePixelColorXY(uint16_t x, uint16_t y, uint8_t fade)                   { setPixelColorXY(x, y, color_fade(getPixelColorXY(x,y), fade, true)); }
-    //void box_blur(unsigned r = 1U, bool smear = false); // 2D box blur
-    void blur2D(uint8_t blur_x, uint8_t blur_y, bool smear = false);
+    void blur2D(uint8_t blur_x, uint8_t blur_y, bool smear = false, uint8_t kernel = BLUR_SMEAR); // separable, rows then columns
+    inline void box_blur(unsigned r = 1U, bool smear = false) { blur2D(r, r, smear, BLUR_BOX); } // 2D box blur
     void moveX(int delta, bool wrap = false);
     void moveY(int delta, bool wrap = false);
     void move(unsigned dir, unsigned delta, bool wrap = false);
@@ -684,6 +870,8 @@ typedef struct Segment {
     inline void setPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0) { setPixelColor(x, RGBW32(r,g,b,w)); }
     inline void setPixelColorXY(int x, int y, CRGB c)                             { setPixelColor(x, RGBW32(c.r,c.g,c.b,0)); }
     inline void setPixelColorXY(unsigned x, unsigned y, CRGB c)                   { setPixelColor(int(x), RGBW32(c.r,c.g,c.b,0)); }
+    inline void setPixelSpanXY(int y, int x0, int x1, uint32_t c)                 { for (int x = x0; x <= x1; x++) setPixelColor(x, c); }
+    inline void setPixelSpanXY(int y, int x0, int x1, const uint32_t *c)          { if (c) for (int x = x0; x <= x1; x++) setPixelColor(x, c[x-x0]); }
     #ifdef WLED_USE_AA_PIXELS
     inline void setPixelColorXY(float x, float y, uint32_t c, bool aa = true)     { setPixelColor(x, c, aa); }
     inline void setPixelColorXY(float x, float y, byte r, byte g, byte b, byte w = 0, bool aa = true) { setPixelColor(x, RGBW32(r,g,b,w), aa); }
@@ -696,8 +884,8 @@ typedef struct Segment {
     inline void addPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0, bool saturate = false) { addPixelColor(x, RGBW32(r,g,b,w), saturate); }
     inline void addPixelColorXY(int x, int y, CRGB c, bool saturate = false)         { addPixelColor(x, RGBW32(c.r,c.g,c.b,0), saturate); }
     inline void fadePixelColorXY(uint16_t x, uint16_t y, uint8_t fade)            { fadePixelColor(x, fade); }
-    //inline void box_blur(unsigned i, bool vertical, fract8 blur_amount) {}
-    inline void blur2D(uint8_t blur_x, uint8_t blur_y, bool smear = false) {}
+    inline void box_blur(unsigned r = 1U, bool smear = false) {}
+    inline void blur2D(uint8_t blur_x, uint8_t blur_y, bool smear = false, uint8_t kernel = BLUR_SMEAR) {}
     inline void blurRow(int row, fract8 blur_amount, bool smear = false) {}
     inline void blurCol(int col, fract8 blur_amount, bool smear = false) {}
     inline void moveX(int delta, bool wrap = false) {}
@@ -761,12 +949,19 @@ class WS2812FX {  // 96 bytes
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
       _triggered(false),
+      _compositing(false),
       _modeCount(MODE_COUNT),
       _callback(nullptr),
       customMappingTable(nullptr),
       customMappingSize(0),
+      _pixels(nullptr),
+      _pixelsLen(0),
+      _layerBlendMode(BLEND_MODE_NORMAL),
+      _layerOpacity(255),
       _lastShow(0),
       _lastServiceShow(0),
+      _frameLoad(0),
+      _schedHold(0),
       _segment_index(0),
       _mainSegment(0)
     {
@@ -779,6 +974,7 @@ class WS2812FX {  // 96 bytes
 
     ~WS2812FX() {
       if (customMappingTable) delete[] customMappingTable;
+      if (_pixels) free(_pixels);
       _mode.clear();
       _modeData.clear();
       _segments.clear();
@@ -805,7 +1001,9 @@ class WS2812FX {  // 96 bytes
       makeAutoSegments(bool forceReset = false),  // will create segments based on configured outputs
       fixInvalidSegments(),                       // fixes incorrect segment configuration
       setPixelColor(unsigned n, uint32_t c),      // paints absolute strip pixel with index n and color c
+      setPixelColors(unsigned n, const uint32_t *c, unsigned count), // paints count consecutive strip pixels starting at n
       show(),                                     // initiates LED output
+      showRealtime(),                             // composites buffered segments (realtime data of main segment) and initiates LED output
       setTargetFps(unsigned fps),
       setupEffectData();                          // add default effects to the list; defined in FX.cpp
 
@@ -860,6 +1058,8 @@ class WS2812FX {  // 96 bytes
 
     inline uint16_t getFps() const          { return (millis() - _lastShow > 2000) ? 0 : (FPS_MULTIPLIER * _cumulativeFps) >> FPS_CALC_SHIFT; } // Returns the refresh rate of the LED strip (_cumulativeFps is stored in fixed point)
     inline uint16_t getFrameTime() const    { return _frametime; }        // returns amount of time a frame should take (in ms)
+    inline uint32_t getFrameBudget() const  { return _targetFps == FPS_UNLIMITED ? 0 : _frametime * 10U * FRAME_BUDGET_PCT; } // effect time budget per frame (in us, 0 = unlimited)
+    inline uint32_t getFrameLoad() const    { return _frameLoad; }        // moving average of effect time per frame (in us)
     inline uint16_t getMinShowDelay() const { return MIN_FRAME_DELAY; }   // returns minimum amount of time strip.service() can be delayed (constant)
     inline uint16_t getLength() const       { return _length; }           // returns actual amount of LEDs on a strip (2D matrix may have less LEDs than W*H)
     inline uint16_t getTransition() const   { return _transitionDur; }    // returns currently set transition time (in ms)
@@ -867,6 +1067,7 @@ class WS2812FX {  // 96 bytes
       if (index < customMappingSize && (realtimeMode == REALTIME_MODE_INACTIVE || realtimeRespectLedMaps)) index = customMappingTable[index];
       return index;
     };
+    inline bool     isLedMapActive() const  { return customMappingSize > 0 && (realtimeMode == REALTIME_MODE_INACTIVE || realtimeRespectLedMaps); }
 
     unsigned long now, timebase;
     uint32_t getPixelColor(unsigned) const;
@@ -955,6 +1156,7 @@ class WS2812FX {  // 96 bytes
       bool _isOffRefreshRequired : 1; //periodic refresh is required for the strip to remain off.
       bool _hasWhiteChannel      : 1;
       bool _triggered            : 1;
+      bool _compositing          : 1; // setPixelColor() blends into strip buffer (see Segment::pushPixels())
     };
 
     uint8_t                  _modeCount;
@@ -966,9 +1168,32 @@ class WS2812FX {  // 96 bytes
     uint16_t* customMappingTable;
     uint16_t  customMappingSize;
 
+    // run of logical pixels that the ledmap places on consecutive pixels of a single bus
+    typedef struct {
+      uint16_t index; // first logical pixel
+      uint16_t count;
+      uint16_t local; // pixel index within bus
+      uint8_t  bus;
+    } route_t;
+    std::vector<route_t> _routes; // sorted by index, empty if ledmap is not in use or does not coalesce
+
+    void updateRoutes(); // rebuild _routes, call whenever ledmap or buses change
+    bool deserializeMapBin(const char *fileName, unsigned n); // load binary ledmap (ledmapN.bin)
+
+    uint32_t* _pixels;        // strip compositing buffer (logical pixel order, before ledmap)
+    uint16_t  _pixelsLen;
+    uint8_t   _layerBlendMode; // blend mode of layer being composited
+    uint8_t   _layerOpacity;   // opacity of layer being composited
+
+    void compositeSegments(); // blends buffered segments into strip buffer and pushes them to busses
+
     unsigned long _lastShow;
     unsigned long _lastServiceShow;
 
+    uint32_t _frameLoad;      // moving average of effect run time per frame in us
+    uint8_t  _schedHold;      // frames until next scheduler decision
+    void scheduleSegments(uint32_t load); // frame budget scheduler, adjusts segment throttling
+
     uint8_t _segment_index;
     uint8_t _mainSegment;
 };
@@ -133,6 +133,7 @@ void WS2812FX::setUpMatrix() {
       resetSegments();
     }
   }
+  updateRoutes();
 #else
   isMatrix = false; // no matter what config says
 #endif
@@ -188,28 +189,88 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
   // negative values of x & y cast into unsigend will become very large values and will therefore be greater than vW/vH
   if (unsigned(x) >= unsigned(vW) || unsigned(y) >= unsigned(vH)) return;  // if pixel would fall out of virtual segment just exit
 
+  if (pixels) {
+    unsigned i = x + y * vW;
+    if (i >= _pixelsLen) return; // safety check (beginDraw() not called)
+#ifndef WLED_DISABLE_MODE_BLEND
+    if (_modeBlend) col = color_blend16(pixels[i], col, 0xFFFFU - progress());
+#endif
+    pixels[i] = col;
+    return;
+  }
+
   // if color is unscaled
   if (!_colorScaled) col = color_fade(col, _segBri);
+  _expandPixelXY(x, y, col);
+}
 
-  if (reverse  ) x = vW - x - 1;
-  if (reverse_y) y = vH - y - 1;
-  if (transpose) { std::swap(x,y); } // swap X & Y if segment transposed
-  unsigned groupLen = groupLength();
-
-  if (groupLen > 1) {
-    int W = width();
-    int H = height();
-    x *= groupLen; // expand to physical pixels
-    y *= groupLen; // expand to physical pixels
-    const int maxY = std::min(y + grouping, H);
-    const int maxX = std::min(x + grouping, W);
-    for (int yY = y; yY < maxY; yY++) {
-      for (int xX = x; xX < maxX; xX++) {
+// expand virtual pixel onto the strip (reverse, transpose, grouping and mirroring)
+// color must already be scaled by segment brightness
+void IRAM_ATTR_YN Segment::_expandPixelXY(int x, int y, uint32_t col)
+{
+  // physical position of first pixel in group (reverse, transpose and grouping are compiled into _geom)
+  int pX = _geom.orgX + x * _geom.xX + y * _geom.yX;
+  int pY = _geom.orgY + x * _geom.xY + y * _geom.yY;
+
+  if (grouping > 1) {
+    const int maxY = std::min(pY + grouping, int(height()));
+    const int maxX = std::min(pX + grouping, int(width()));
+    for (int yY = pY; yY < maxY; yY++) {
+      for (int xX = pX; xX < maxX; xX++) {
         _setPixelColorXY_raw(xX, yY, col);
       }
     }
   } else {
-    _setPixelColorXY_raw(x, y, col);
+    _setPixelColorXY_raw(pX, pY, col);
+  }
+}
+
+// write a horizontal run of pixels x0..x1 (inclusive) in row y using single color col or colors from cols (cols[0] belongs to x0)
+// clipping and segment transform (reverse, transpose, grouping) are resolved once per run instead of once per pixel
+void IRAM_ATTR_YN Segment::_setPixelSpanXY(int y, int x0, int x1, uint32_t col, const uint32_t *cols)
+{
+  if (!isActive()) return; // not active
+  const int vW = vWidth();   // segment width in logical pixels (can be 0 if segment is inactive)
+  const int vH = vHeight();  // segment height in logical pixels (is always >= 1)
+  if (x0 > x1) std::swap(x0, x1);
+  if (unsigned(y) >= unsigned(vH) || x1 < 0 || x0 >= vW) return; // run falls out of virtual segment
+  if (cols) cols -= x0; // so that cols[x] is the color of pixel x
+  if (x0 < 0) x0 = 0;
+  if (x1 >= vW) x1 = vW - 1;
+
+  if (pixels) {
+    uint32_t *row = pixels + y * vW;
+    if (row + x1 >= pixels + _pixelsLen) return; // safety check (beginDraw() not called)
+#ifndef WLED_DISABLE_MODE_BLEND
+    if (_modeBlend) {
+      const uint16_t keep = 0xFFFFU - progress();
+      for (int x = x0; x <= x1; x++) row[x] = color_blend16(row[x], cols ? cols[x] : col, keep);
+      return;
+    }
+#endif
+    if (cols) memcpy(row + x0, cols + x0, (x1 - x0 + 1) * sizeof(uint32_t));
+    else      for (int x = x0; x <= x1; x++) row[x] = col;
+    return;
+  }
+
+  // unbuffered segment: map the run onto the strip, walking physical position with compiled strides
+  const bool scale = !_colorScaled;
+  if (!cols && scale) col = color_fade(col, _segBri);
+  const int W = width();
+  const int H = height();
+  int pX = _geom.orgX + x0 * _geom.xX + y * _geom.yX;
+  int pY = _geom.orgY + x0 * _geom.xY + y * _geom.yY;
+  for (int x = x0; x <= x1; x++, pX += _geom.xX, pY += _geom.xY) {
+    uint32_t c = col;
+    if (cols) c = scale ? color_fade(cols[x], _segBri) : cols[x];
+    if (grouping > 1) {
+      const int maxY = std::min(pY + grouping, H);
+      const int maxX = std::min(pX + grouping, W);
+      for (int yY = pY; yY < maxY; yY++) for (int xX = pX; xX < maxX; xX++) _setPixelColorXY_raw(xX, yY, c);
+    } else {
+      int px = pX, py = pY; // _setPixelColorXY_raw() takes references
+      _setPixelColorXY_raw(px, py, c);
+    }
   }
 }
 
@@ -262,144 +323,56 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColorXY(int x, int y) const {
   const int vW = vWidth();
   const int vH = vHeight();
   if (unsigned(x) >= unsigned(vW) || unsigned(y) >= unsigned(vH)) return 0;  // if pixel would fall out of virtual segment just exit
-  if (reverse  ) x = vW - x - 1;
-  if (reverse_y) y = vH - y - 1;
-  if (transpose) { std::swap(x,y); } // swap X & Y if segment transposed
-  x *= groupLength(); // expand to physical pixels
-  y *= groupLength(); // expand to physical pixels
-  if (x >= width() || y >= height()) return 0;
-  return strip.getPixelColorXY(start + x, startY + y);
+  if (pixels) {
+    unsigned i = x + y * vW;
+    return i < _pixelsLen ? pixels[i] : 0;
+  }
+  const int pX = _geom.orgX + x * _geom.xX + y * _geom.yX; // expand to physical pixels
+  const int pY = _geom.orgY + x * _geom.xY + y * _geom.yY;
+  if (pX >= int(width()) || pY >= int(height())) return 0;
+  return strip.getPixelColorXY(start + pX, startY + pY);
 }
 
 // 2D blurring, can be asymmetrical
-void Segment::blur2D(uint8_t blur_x, uint8_t blur_y, bool smear) {
-  if (!isActive()) return; // not active
+// separable: rows are blurred first, then columns; each line is copied to a scratch row so it can be filtered out of place
+// blur_x/blur_y are blur amounts for BLUR_SMEAR and radii for BLUR_BOX and BLUR_GAUSS
+void Segment::blur2D(uint8_t blur_x, uint8_t blur_y, bool smear, uint8_t kernel) {
+  if (!isActive() || (!blur_x && !blur_y)) return; // not active
   const unsigned cols = vWidth();
   const unsigned rows = vHeight();
-  uint32_t lastnew;
-  uint32_t last;
-  if (blur_x) {
-    const uint8_t keepx = smear ? 255 : 255 - blur_x;
-    const uint8_t seepx = blur_x >> 1;
-    for (unsigned row = 0; row < rows; row++) { // blur rows (x direction)
-      uint32_t carryover = BLACK;
-      uint32_t curnew = BLACK;
-      for (unsigned x = 0; x < cols; x++) {
-        uint32_t cur = getPixelColorXY(x, row);
-        uint32_t part = color_fade(cur, seepx);
-        curnew = color_fade(cur, keepx);
-        if (x > 0) {
-          if (carryover) curnew = color_add(curnew, carryover);
-          uint32_t prev = color_add(lastnew, part);
-          // optimization: only set pixel if color has changed
-          if (last != prev) setPixelColorXY(x - 1, row, prev);
-        } else setPixelColorXY(x, row, curnew); // first pixel
-        lastnew = curnew;
-        last = cur; // save original value for comparison on next iteration
-        carryover = part;
-      }
-      setPixelColorXY(cols-1, row, curnew); // set last pixel
+  const unsigned maxLen = std::max(cols, rows);
+  const bool buffered = pixels && cols * rows <= _pixelsLen;
+  const unsigned srcLen = (kernel == BLUR_GAUSS ? 2 : 1) * maxLen; // gauss needs an intermediate line
+  uint32_t *line = _getBlurRow(srcLen + (buffered ? 0 : maxLen));
+  if (!line) return; // not enough memory
+  if (buffered) {
+    // buffered segment: blur directly in buffer using row/column stride
+    if (blur_x) for (unsigned row = 0; row < rows; row++) {
+      uint32_t *p = &pixels[row * cols];
+      memcpy(line, p, cols * sizeof(uint32_t));
+      _blurLine(p, 1, line, cols, kernel, blur_x, smear);
     }
-  }
-  if (blur_y) {
-    const uint8_t keepy = smear ? 255 : 255 - blur_y;
-    const uint8_t seepy = blur_y >> 1;
-    for (unsigned col = 0; col < cols; col++) {
-      uint32_t carryover = BLACK;
-      uint32_t curnew = BLACK;
-      for (unsigned y = 0; y < rows; y++) {
-        uint32_t cur = getPixelColorXY(col, y);
-        uint32_t part = color_fade(cur, seepy);
-        curnew = color_fade(cur, keepy);
-        if (y > 0) {
-          if (carryover) curnew = color_add(curnew, carryover);
-          uint32_t prev = color_add(lastnew, part);
-          // optimization: only set pixel if color has changed
-          if (last != prev) setPixelColorXY(col, y - 1, prev);
-        } else setPixelColorXY(col, y, curnew); // first pixel
-        lastnew = curnew;
-        last = cur; //save original value for comparison on next iteration
-        carryover = part;
-      }
-      setPixelColorXY(col, rows - 1, curnew);
+    if (blur_y) for (unsigned col = 0; col < cols; col++) {
+      uint32_t *p = &pixels[col];
+      for (unsigned y = 0; y < rows; y++) line[y] = p[y * cols];
+      _blurLine(p, cols, line, rows, kernel, blur_y, smear);
     }
-  }
-}
-
-/*
-// 2D Box blur
-void Segment::box_blur(unsigned radius, bool smear) {
-  if (!isActive() || radius == 0) return; // not active
-  if (radius > 3) radius = 3;
-  const unsigned d = (1 + 2*radius) * (1 + 2*radius); // averaging divisor
-  const unsigned cols = vWidth();
-  const unsigned rows = vHeight();
-  uint16_t *tmpRSum = new uint16_t[cols*rows];
-  uint16_t *tmpGSum = new uint16_t[cols*rows];
-  uint16_t *tmpBSum = new uint16_t[cols*rows];
-  uint16_t *tmpWSum = new uint16_t[cols*rows];
-  // fill summed-area table (https://en.wikipedia.org/wiki/Summed-area_table)
-  for (unsigned x = 0; x < cols; x++) {
-    unsigned rS, gS, bS, wS;
-    unsigned index;
-    rS = gS = bS = wS = 0;
-    for (unsigned y = 0; y < rows; y++) {
-      index = x * cols + y;
-      if (x > 0) {
-        unsigned index2 = (x - 1) * cols + y;
-        tmpRSum[index] = tmpRSum[index2];
-        tmpGSum[index] = tmpGSum[index2];
-        tmpBSum[index] = tmpBSum[index2];
-        tmpWSum[index] = tmpWSum[index2];
-      } else {
-        tmpRSum[index] = 0;
-        tmpGSum[index] = 0;
-        tmpBSum[index] = 0;
-        tmpWSum[index] = 0;
-      }
-      uint32_t c = getPixelColorXY(x, y);
-      rS += R(c);
-      gS += G(c);
-      bS += B(c);
-      wS += W(c);
-      tmpRSum[index] += rS;
-      tmpGSum[index] += gS;
-      tmpBSum[index] += bS;
-      tmpWSum[index] += wS;
+  } else {
+    uint32_t *out = line + srcLen;
+    if (blur_x) for (unsigned row = 0; row < rows; row++) { // blur rows (x direction)
+      for (unsigned x = 0; x < cols; x++) line[x] = getPixelColorXY(x, row);
+      _blurLine(out, 1, line, cols, kernel, blur_x, smear);
+      setPixelSpanXY(row, 0, cols - 1, out);
     }
-  }
-  // do a box blur using pre-calculated sums
-  for (unsigned x = 0; x < cols; x++) {
-    for (unsigned y = 0; y < rows; y++) {
-      // sum = D + A - B - C where k = (x,y)
-      // +----+-+---- (x)
-      // |    | |
-      // +----A-B
-      // |    |k|
-      // +----C-D
-      // |
-      //(y)
-      unsigned x0 = x < radius ? 0 : x - radius;
-      unsigned y0 = y < radius ? 0 : y - radius;
-      unsigned x1 = x >= cols - radius ? cols - 1 : x + radius;
-      unsigned y1 = y >= rows - radius ? rows - 1 : y + radius;
-      unsigned A = x0 * cols + y0;
-      unsigned B = x1 * cols + y0;
-      unsigned C = x0 * cols + y1;
-      unsigned D = x1 * cols + y1;
-      unsigned r = tmpRSum[D] + tmpRSum[A] - tmpRSum[C] - tmpRSum[B];
-      unsigned g = tmpGSum[D] + tmpGSum[A] - tmpGSum[C] - tmpGSum[B];
-      unsigned b = tmpBSum[D] + tmpBSum[A] - tmpBSum[C] - tmpBSum[B];
-      unsigned w = tmpWSum[D] + tmpWSum[A] - tmpWSum[C] - tmpWSum[B];
-      setPixelColorXY(x, y, RGBW32(r/d, g/d, b/d, w/d));
+    if (blur_y) for (unsigned col = 0; col < cols; col++) { // blur columns (y direction)
+      for (unsigned y = 0; y < rows; y++) line[y] = getPixelColorXY(col, y);
+      _blurLine(out, 1, line, rows, kernel, blur_y, smear);
+      for (unsigned y = 0; y < rows; y++) setPixelColorXY(col, y, out[y]);
     }
   }
-  delete[] tmpRSum;
-  delete[] tmpGSum;
-  delete[] tmpBSum;
-  delete[] tmpWSum;
+  _freeBlurRow();
 }
-*/
+
 void Segment::moveX(int delta, bool wrap) {
   if (!isActive() || !delta) return; // not active
   const int vW = vWidth();   // segment width in logical pixels (can be 0 if segment is inactive)
@@ -422,7 +395,7 @@ void Segment::moveX(int delta, bool wrap) {
       if (wrap) srcX %= vW; // Wrap using modulo when `wrap` is true
       newPxCol[x] = getPixelColorXY(srcX, y);
     }
-    for (int x = 0; x < stop; x++) setPixelColorXY(x + start, y, newPxCol[x]);
+    setPixelSpanXY(y, start, start + stop - 1, newPxCol);
   }
 }
 
@@ -432,23 +405,33 @@ void Segment::moveY(int delta, bool wrap) {
   const int vH = vHeight();  // segment height in logical pixels (is always >= 1)
   int absDelta = abs(delta);
   if (absDelta >= vH) return;
-  uint32_t newPxCol[vH];
-  int newDelta;
-  int stop = vH;
-  int start = 0;
-  if (wrap) newDelta = (delta + vH) % vH; // +rows in case delta < 0
-  else {
-    if (delta < 0) start = absDelta;
-    stop = vH - absDelta;
-    newDelta = delta > 0 ? delta : 0;
-  }
-  for (int x = 0; x < vW; x++) {
-    for (int y = 0; y < stop; y++) {
-      int srcY = y + newDelta;
-      if (wrap) srcY %= vH; // Wrap using modulo when `wrap` is true
-      newPxCol[y] = getPixelColorXY(x, srcY);
+  uint32_t rowCol[vW];
+  // whole rows are moved so that each row is written as a single span
+  auto copyRow = [&](int dst, int src) {
+    for (int x = 0; x < vW; x++) rowCol[x] = getPixelColorXY(x, src);
+    setPixelSpanXY(dst, 0, vW - 1, rowCol);
+  };
+  if (wrap) {
+    // rotate rows (row y receives row y+delta) by following each permutation cycle
+    const int newDelta = (delta + vH) % vH; // +rows in case delta < 0
+    uint32_t firstCol[vW];
+    int cycles = vH, b = newDelta;
+    while (b) { int t = cycles % b; cycles = b; b = t; } // gcd(vH, newDelta)
+    for (int c = 0; c < cycles; c++) {
+      for (int x = 0; x < vW; x++) firstCol[x] = getPixelColorXY(x, c);
+      int y = c;
+      for (;;) {
+        int srcY = (y + newDelta) % vH;
+        if (srcY == c) break;
+        copyRow(y, srcY);
+        y = srcY;
+      }
+      setPixelSpanXY(y, 0, vW - 1, firstCol);
     }
-    for (int y = 0; y < stop; y++) setPixelColorXY(x, y + start, newPxCol[y]);
+  } else if (delta > 0) {
+    for (int y = 0; y < vH - absDelta; y++) copyRow(y, y + absDelta);          // source rows are below destination
+  } else {
+    for (int y = vH - absDelta - 1; y >= 0; y--) copyRow(y + absDelta, y);     // source rows are above destination
   }
 }
 
@@ -505,8 +488,10 @@ void Segment::drawCircle(uint16_t cx, uint16_t cy, uint8_t radius, uint32_t col,
     }
   } else {
     // pre-scale color for all pixels
-    col = color_fade(col, _segBri);
-    _colorScaled = true;
+    if (!pixels) {
+      col = color_fade(col, _segBri);
+      _colorScaled = true;
+    }
     // Bresenham’s Algorithm
     int d = 3 - (2*radius);
     int y = radius, x = 0;
@@ -532,21 +517,18 @@ void Segment::drawCircle(uint16_t cx, uint16_t cy, uint8_t radius, uint32_t col,
 // by stepko, taken from https://editor.soulmatelights.com/gallery/573-blobs
 void Segment::fillCircle(uint16_t cx, uint16_t cy, uint8_t radius, uint32_t col, bool soft) {
   if (!isActive() || radius == 0) return; // not active
-  const int vW = vWidth();   // segment width in logical pixels (can be 0 if segment is inactive)
-  const int vH = vHeight();  // segment height in logical pixels (is always >= 1)
   // draw soft bounding circle
   if (soft) drawCircle(cx, cy, radius, col, soft);
   // pre-scale color for all pixels
-  col = color_fade(col, _segBri);
-  _colorScaled = true;
-  // fill it
+  if (!pixels) {
+    col = color_fade(col, _segBri);
+    _colorScaled = true;
+  }
+  // fill it, one span per row (clipping is done by setPixelSpanXY())
+  const int rsq = radius * radius;
   for (int y = -radius; y <= radius; y++) {
-    for (int x = -radius; x <= radius; x++) {
-      if (x * x + y * y <= radius * radius &&
-          int(cx)+x >= 0 && int(cy)+y >= 0 &&
-          int(cx)+x < vW && int(cy)+y < vH)
-        setPixelColorXY(cx + x, cy + y, col);
-    }
+    const int x = sqrt16(rsq - y * y); // widest x where x*x + y*y <= radius*radius
+    setPixelSpanXY(int(cy) + y, int(cx) - x, int(cx) + x, col);
   }
   _colorScaled = false;
 }
@@ -595,16 +577,29 @@ void Segment::drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint3
     }
   } else {
     // pre-scale color for all pixels
-    c = color_fade(c, _segBri);
-    _colorScaled = true;
-    // Bresenham's algorithm
+    if (!pixels) {
+      c = color_fade(c, _segBri);
+      _colorScaled = true;
+    }
+    // Bresenham's algorithm, consecutive pixels in the same row are written as a single span
     int err = (dx>dy ? dx : -dy)/2;   // error direction
+    int x = x0, y = y0;
+    int runX = x;                     // start of current horizontal run
     for (;;) {
-      setPixelColorXY(x0, y0, c);
-      if (x0==x1 && y0==y1) break;
+      if (x==x1 && y==y1) {
+        setPixelSpanXY(y, runX, x, c);
+        break;
+      }
       int e2 = err;
-      if (e2 >-dx) { err -= dy; x0 += sx; }
-      if (e2 < dy) { err += dx; y0 += sy; }
+      int nx = x, ny = y;
+      if (e2 >-dx) { err -= dy; nx += sx; }
+      if (e2 < dy) { err += dx; ny += sy; }
+      if (ny != y) {
+        setPixelSpanXY(y, runX, x, c);
+        runX = nx;
+      }
+      x = nx;
+      y = ny;
     }
     _colorScaled = false;
   }
@@ -641,20 +636,31 @@ void Segment::drawCharacter(unsigned char chr, int16_t x, int16_t y, uint8_t w,
     }
     uint32_t c = ColorFromPaletteWLED(grad, (i+1)*255/h, 255, NOBLEND);
     // pre-scale color for all pixels
-    c = color_fade(c, _segBri);
-    _colorScaled = true;
-    for (int j = 0; j<w; j++) { // character width
-      int x0, y0;
-      switch (rotate) {
-        case -1: x0 = x + (h-1) - i; y0 = y + (w-1) - j; break; // -90 deg
-        case -2:
-        case  2: x0 = x + j;         y0 = y + (h-1) - i; break; // 180 deg
-        case  1: x0 = x + i;         y0 = y + j;         break; // +90 deg
-        default: x0 = x + (w-1) - j; y0 = y + i;         break; // no rotation
+    if (!pixels) {
+      c = color_fade(c, _segBri);
+      _colorScaled = true;
+    }
+    if (rotate == 1 || rotate == -1) {
+      // character row is drawn as a screen column
+      for (int j = 0; j<w; j++) { // character width
+        int x0 = rotate > 0 ? x + i : x + (h-1) - i;
+        int y0 = rotate > 0 ? y + j : y + (w-1) - j;
+        if (x0 < 0 || x0 >= (int)vWidth() || y0 < 0 || y0 >= (int)vHeight()) continue; // drawing off-screen
+        if (((bits>>(j+(8-w))) & 0x01)) { // bit set
+          setPixelColorXY(x0, y0, c);
+        }
       }
-      if (x0 < 0 || x0 >= (int)vWidth() || y0 < 0 || y0 >= (int)vHeight()) continue; // drawing off-screen
-      if (((bits>>(j+(8-w))) & 0x01)) { // bit set
-        setPixelColorXY(x0, y0, c);
+    } else {
+      // character row is drawn as a screen row: write runs of set bits as spans (clipping is done by setPixelSpanXY())
+      const bool flip = (rotate == 2 || rotate == -2); // 180 deg
+      const int y0 = flip ? y + (h-1) - i : y + i;
+      for (int j = 0; j<w; j++) { // character width
+        if (!((bits>>(j+(8-w))) & 0x01)) continue;
+        int k = j;
+        while (k+1 < w && ((bits>>(k+1+(8-w))) & 0x01)) k++; // bits j..k are set
+        if (flip) setPixelSpanXY(y0, x + j, x + k, c);
+        else      setPixelSpanXY(y0, x + (w-1) - k, x + (w-1) - j, c);
+        j = k;
       }
     }
     _colorScaled = false;
@@ -27,6 +27,9 @@
   {"map":[
   0, 1, 2, 3, 4, 9, 8, 7, 6, 5, 10, 11, 12, 13, 14,
   19, 18, 17, 16, 15, 20, 21, 22, 23, 24, 29, 28, 27, 26, 25]}
+
+  Large maps can be converted to binary "ledmap.bin" with tools/ledmap_bin.py.
+  Binary maps are loaded without using the JSON buffer and take precedence over "ledmap.json".
 */
 
 #ifndef PIXEL_COUNTS
@@ -63,10 +66,164 @@ static constexpr bool validatePinsAndTypes(const unsigned* types, unsigned numTy
 }
 
 
+// segment buffers (effect data arena, pixel buffer pool) are allocated and released by the web server task (segment copies and removal)
+// as well as in loop(), realtime data of the main segment is written by the UDP task
+// on ESP32 these run concurrently (ESP8266 web server and UDP callbacks do not interrupt loop())
+#ifdef ARDUINO_ARCH_ESP32
+static SemaphoreHandle_t segmentBufferMutex = xSemaphoreCreateRecursiveMutex();
+SegmentBufferLock::SegmentBufferLock()  { xSemaphoreTakeRecursive(segmentBufferMutex, portMAX_DELAY); }
+SegmentBufferLock::~SegmentBufferLock() { xSemaphoreGiveRecursive(segmentBufferMutex); }
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////
+// DataArena class implementation
+///////////////////////////////////////////////////////////////////////////////
+#define ARENA_ALIGN(x) (((x) + 3U) & ~3U)
+
+bool DataArena::begin(size_t size) {
+  if (_buf) return true;
+  size = ARENA_ALIGN(size);
+  // do not use SPI RAM on ESP32 since it is slow
+  _buf = (byte*)malloc(size);
+  if (!_buf) { DEBUG_PRINTLN(F("!!! Effect data arena allocation failed. !!!")); return false; }
+  _size = size;
+  _top = _used = 0;
+  _fragmented = false;
+  return true;
+}
+
+DataArena::handle_t DataArena::alloc(size_t len) {
+  if (len == 0) return 0;
+  handle_t h = 1;
+  while (h < DATA_ARENA_HANDLES && _slots[h]) h++;
+  if (h >= DATA_ARENA_HANDLES) return 0; // out of handles
+  const size_t need = sizeof(blockhdr_t) + ARENA_ALIGN(len);
+  size_t pos = SIZE_MAX;
+  if (_buf && _fragmented) {
+    // first fit into a free block (merging adjacent free blocks), split it if the remainder can hold another block
+    bool holes = false; // free blocks remain below top
+    for (size_t p = 0; p < _top; ) {
+      blockhdr_t *blk = reinterpret_cast<blockhdr_t*>(_buf + p);
+      if (!blk->handle) {
+        size_t next = p + sizeof(blockhdr_t) + blk->len;
+        while (next < _top) {
+          const blockhdr_t *nxt = reinterpret_cast<const blockhdr_t*>(_buf + next);
+          if (nxt->handle) break;
+          blk->len += sizeof(blockhdr_t) + nxt->len;
+          next = p + sizeof(blockhdr_t) + blk->len;
+        }
+        if (next >= _top) { _top = p; break; } // free space reaches top
+        const size_t blkSize = sizeof(blockhdr_t) + blk->len;
+        if (pos == SIZE_MAX && blkSize >= need) {
+          if (blkSize - need > sizeof(blockhdr_t)) {
+            blockhdr_t *rest = reinterpret_cast<blockhdr_t*>(_buf + p + need);
+            rest->len    = blkSize - need - sizeof(blockhdr_t);
+            rest->handle = 0;
+            blk->len = need - sizeof(blockhdr_t);
+          }
+          blk->handle = h; // reserve (remainder is checked in next iteration)
+          pos = p;
+        } else
+          holes = true;
+      }
+      p += sizeof(blockhdr_t) + blk->len;
+    }
+    _fragmented = holes;
+  }
+  if (pos == SIZE_MAX) {
+    if (!_buf || _top + need > _size) {
+      if (_buf && _used + need <= _size) _failed++; // enough space in total, but fragmented
+      // arena is full, place block on the heap (it is not moved by compact())
+      if (ESP.getFreeHeap() < MIN_HEAP_SIZE + need) return 0;
+      blockhdr_t *blk = (blockhdr_t*)malloc(need);
+      if (!blk) return 0;
+      blk->len    = need - sizeof(blockhdr_t);
+      blk->handle = h;
+      _heapUsed += need;
+      _onHeap[h] = true;
+      _slots[h]  = reinterpret_cast<byte*>(blk) + sizeof(blockhdr_t);
+      return h;
+    }
+    pos = _top;
+    _top += need;
+    reinterpret_cast<blockhdr_t*>(_buf + pos)->len = need - sizeof(blockhdr_t);
+  }
+  blockhdr_t *blk = reinterpret_cast<blockhdr_t*>(_buf + pos);
+  blk->handle = h;
+  _used += sizeof(blockhdr_t) + blk->len;
+  _slots[h] = _buf + pos + sizeof(blockhdr_t);
+  return h;
+}
+
+void DataArena::release(handle_t h) {
+  byte *p = get(h);
+  if (!p) return;
+  blockhdr_t *blk = reinterpret_cast<blockhdr_t*>(p - sizeof(blockhdr_t));
+  _slots[h] = nullptr;
+  if (_onHeap[h]) {
+    _heapUsed -= sizeof(blockhdr_t) + blk->len;
+    _onHeap[h] = false;
+    free(blk);
+    return;
+  }
+  blk->handle = 0;
+  _used -= sizeof(blockhdr_t) + blk->len;
+  if (p + blk->len == _buf + _top) _top -= sizeof(blockhdr_t) + blk->len; // last block: shrink
+  else                             _fragmented = true;
+  if (_used == 0) { _top = 0; _fragmented = false; }
+}
+
+// moves all used blocks to the start of the arena (closing the gaps left by released blocks)
+bool DataArena::compact() {
+  if (!_fragmented) return false;
+  bool moved = false;
+  size_t dst = 0;
+  for (size_t src = 0; src < _top; ) {
+    blockhdr_t *blk = reinterpret_cast<blockhdr_t*>(_buf + src);
+    const size_t blkSize = sizeof(blockhdr_t) + blk->len;
+    if (blk->handle) {
+      if (dst != src) {
+        memmove(_buf + dst, _buf + src, blkSize);
+        _slots[reinterpret_cast<blockhdr_t*>(_buf + dst)->handle] = _buf + dst + sizeof(blockhdr_t);
+        moved = true;
+      }
+      dst += blkSize;
+    }
+    src += blkSize;
+  }
+  _top = dst;
+  _fragmented = false;
+  if (moved) _compactions++;
+  return moved;
+}
+
+size_t DataArena::getLargestFree() const {
+  size_t largest = _size - _top;
+  for (size_t p = 0; p < _top; ) {
+    const blockhdr_t *blk = reinterpret_cast<const blockhdr_t*>(_buf + p);
+    if (!blk->handle && blk->len > largest) largest = blk->len;
+    p += sizeof(blockhdr_t) + blk->len;
+  }
+  return largest;
+}
+
+unsigned DataArena::getHoles() const {
+  unsigned holes = 0;
+  for (size_t p = 0; p < _top; ) {
+    const blockhdr_t *blk = reinterpret_cast<const blockhdr_t*>(_buf + p);
+    if (!blk->handle) holes++;
+    p += sizeof(blockhdr_t) + blk->len;
+  }
+  return holes;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Segment class implementation
 ///////////////////////////////////////////////////////////////////////////////
 unsigned      Segment::_usedSegmentData   = 0U; // amount of RAM all segments use for their data[]
+DataArena     Segment::_dataArena;
 uint16_t      Segment::maxWidth           = DEFAULT_LED_COUNT;
 uint16_t      Segment::maxHeight          = 1;
 unsigned      Segment::_vLength           = 0;
@@ -81,21 +238,38 @@ CRGBPalette16 Segment::_newRandomPalette  = generateRandomPalette();  // was CRG
 uint16_t      Segment::_lastPaletteChange = 0; // perhaps it should be per segment
 uint16_t      Segment::_lastPaletteBlend  = 0; //in millis (lowest 16 bits only)
 uint16_t      Segment::_transitionprogress  = 0xFFFF;
+uint32_t     *Segment::_blurRow           = nullptr;
+unsigned      Segment::_blurRowLen        = 0;
 
 #ifndef WLED_DISABLE_MODE_BLEND
 bool Segment::_modeBlend = false;
 #endif
 
+static uint32_t *acquirePixelBuffer(unsigned len); // pixel buffer pool, see below
+
 // copy constructor
-Segment::Segment(const Segment &orig) {
+Segment::Segment(const Segment &orig, bool withBuffers) {
   //DEBUG_PRINTF_P(PSTR("-- Copy segment constructor: %p -> %p\n"), &orig, this);
   memcpy((void*)this, (void*)&orig, sizeof(Segment));
   _t = nullptr; // copied segment cannot be in transition
   name = nullptr;
   data = nullptr;
+  _dataHandle = 0;
   _dataLen = 0;
+  pixels = nullptr;
+  _pixelsLen = 0;
+  _palCache = nullptr; // will be rebuilt on first use
   if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
-  if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
+  if (!withBuffers) return;
+  if (orig.data) {
+    SegmentBufferLock lock; // effect data must not be moved while copying
+    if (allocateData(orig._dataLen)) memcpy(data, _dataArena.get(orig._dataHandle), orig._dataLen);
+  }
+  if (orig.pixels) {
+    SegmentBufferLock lock; // source buffer may be written by UDP task
+    pixels = acquirePixelBuffer(orig._pixelsLen); // stays nullptr if heap is low, segment will draw directly
+    if (pixels) { memcpy(pixels, orig.pixels, orig._pixelsLen * sizeof(uint32_t)); _pixelsLen = orig._pixelsLen; }
+  }
 }
 
 // move constructor
@@ -105,7 +279,11 @@ Segment::Segment(Segment &&orig) noexcept {
   orig._t   = nullptr; // old segment cannot be in transition any more
   orig.name = nullptr;
   orig.data = nullptr;
+  orig._dataHandle = 0;
   orig._dataLen = 0;
+  orig.pixels = nullptr;
+  orig._pixelsLen = 0;
+  orig._palCache = nullptr;
 }
 
 // copy assignment
@@ -116,14 +294,28 @@ Segment& Segment::operator= (const Segment &orig) {
     if (name) { delete[] name; name = nullptr; }
     stopTransition();
     deallocateData();
+    deallocatePixels();
+    if (_palCache) free(_palCache);
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
+    _dataHandle = 0;
     _dataLen = 0;
+    pixels = nullptr;
+    _pixelsLen = 0;
+    _palCache = nullptr;
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
-    if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
+    if (orig.data) {
+      SegmentBufferLock lock; // effect data must not be moved while copying
+      if (allocateData(orig._dataLen)) memcpy(data, _dataArena.get(orig._dataHandle), orig._dataLen);
+    }
+    if (orig.pixels) {
+      SegmentBufferLock lock; // source buffer may be written by UDP task
+      pixels = acquirePixelBuffer(orig._pixelsLen); // stays nullptr if heap is low, segment will draw directly
+      if (pixels) { memcpy(pixels, orig.pixels, orig._pixelsLen * sizeof(uint32_t)); _pixelsLen = orig._pixelsLen; }
+    }
   }
   return *this;
 }
@@ -135,16 +327,22 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (name) { delete[] name; name = nullptr; } // free old name
     stopTransition();
     deallocateData(); // free old runtime data
+    deallocatePixels(); // free old pixel buffer
+    if (_palCache) free(_palCache);
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
+    orig._palCache = nullptr;
     orig.name = nullptr;
     orig.data = nullptr;
+    orig._dataHandle = 0;
     orig._dataLen = 0;
+    orig.pixels = nullptr;
+    orig._pixelsLen = 0;
     orig._t   = nullptr; // old segment cannot be in transition
   }
   return *this;
 }
 
-// allocates effect data buffer on heap and initialises (erases) it
+// allocates effect data buffer in effect data arena and initialises (erases) it
 bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
   if (len == 0) return false; // nothing to do
   if (data && _dataLen >= len) {          // already allocated enough (reduce fragmentation)
@@ -152,6 +350,7 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
     return true;
   }
   //DEBUG_PRINTF_P(PSTR("--   Allocating data (%d): %p\n", len, this);
+  SegmentBufferLock lock;
   deallocateData(); // if the old buffer was smaller release it first
   if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
     // not enough memory
@@ -160,9 +359,11 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
     errorFlag = ERR_NORAM;
     return false;
   }
-  // do not use SPI RAM on ESP32 since it is slow
-  data = (byte*)calloc(len, sizeof(byte));
-  if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } // allocation failed
+  _dataArena.begin(DATA_ARENA_SIZE); // if arena cannot be allocated, data is placed on the heap
+  _dataHandle = _dataArena.alloc(len);
+  if (!_dataHandle) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); errorFlag = ERR_NORAM; return false; }
+  data = _dataArena.get(_dataHandle);
+  memset(data, 0, len);
   Segment::addUsedSegmentData(len);
   //DEBUG_PRINTF_P(PSTR("---  Allocated data (%p): %d/%d -> %p\n"), this, len, Segment::getUsedSegmentData(), data);
   _dataLen = len;
@@ -171,17 +372,120 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
 
 void IRAM_ATTR_YN Segment::deallocateData() {
   if (!data) { _dataLen = 0; return; }
+  SegmentBufferLock lock;
   //DEBUG_PRINTF_P(PSTR("---  Released data (%p): %d/%d -> %p\n"), this, _dataLen, Segment::getUsedSegmentData(), data);
   if ((Segment::getUsedSegmentData() > 0) && (_dataLen > 0)) { // check that we don't have a dangling / inconsistent data pointer
-    free(data);
+    _dataArena.release(_dataHandle);
   } else {
     DEBUG_PRINTF_P(PSTR("---- Released data (%p): inconsistent UsedSegmentData (%d/%d), cowardly refusing to free nothing.\n"), this, _dataLen, Segment::getUsedSegmentData());
   }
   data = nullptr;
+  _dataHandle = 0;
   Segment::addUsedSegmentData(_dataLen <= Segment::getUsedSegmentData() ? -_dataLen : -Segment::getUsedSegmentData());
   _dataLen = 0;
 }
 
+void Segment::refreshData() {
+  data = _dataArena.get(_dataHandle);
+  #ifndef WLED_DISABLE_MODE_BLEND
+  if (_t) _t->_segT._dataT = _dataArena.get(_t->_segT._dataHandleT);
+  #endif
+}
+
+// small pool of released pixel buffers
+// transitions and geometry changes allocate and release buffers of the same size repeatedly, reusing them
+// avoids heap fragmentation (all buffers are allocated with malloc() so they are interchangeable)
+#ifdef ESP8266
+#define PIXEL_POOL_SIZE  2
+#define PIXEL_POOL_BYTES 4096   // max memory held by released buffers
+#else
+#define PIXEL_POOL_SIZE  4
+#define PIXEL_POOL_BYTES 32768
+#endif
+static struct {
+  uint32_t *ptr;
+  unsigned  len;
+} pixelPool[PIXEL_POOL_SIZE] = {};
+
+// returns (uninitialised) buffer of at least len pixels, taken from pool if possible
+static uint32_t *acquirePixelBuffer(unsigned len) {
+  SegmentBufferLock lock;
+  int best = -1;
+  for (int i = 0; i < PIXEL_POOL_SIZE; i++) {
+    if (pixelPool[i].ptr && pixelPool[i].len >= len && (best < 0 || pixelPool[i].len < pixelPool[best].len)) best = i;
+  }
+  if (best >= 0) {
+    uint32_t *p = pixelPool[best].ptr;
+    pixelPool[best].ptr = nullptr;
+    pixelPool[best].len = 0;
+    return p;
+  }
+  // leave enough heap for web server
+  if (ESP.getFreeHeap() < MIN_HEAP_SIZE + len * sizeof(uint32_t)) return nullptr;
+  return (uint32_t*)malloc(len * sizeof(uint32_t));
+}
+
+// returns buffer to pool (replacing smaller buffer if pool is full) or frees it
+static void releasePixelBuffer(uint32_t *p, unsigned len) {
+  if (!p) return;
+  SegmentBufferLock lock;
+  if (ESP.getFreeHeap() >= 2*MIN_HEAP_SIZE) { // do not hoard memory if heap is low
+    int slot = -1;
+    size_t pooled = 0;
+    for (int i = 0; i < PIXEL_POOL_SIZE; i++) pooled += pixelPool[i].len * sizeof(uint32_t);
+    for (int i = 0; i < PIXEL_POOL_SIZE; i++) {
+      if (!pixelPool[i].ptr) { slot = i; break; }
+      if (pixelPool[i].len < len && (slot < 0 || pixelPool[i].len < pixelPool[slot].len)) slot = i;
+    }
+    if (slot >= 0 && pooled - pixelPool[slot].len * sizeof(uint32_t) + len * sizeof(uint32_t) > PIXEL_POOL_BYTES) slot = -1;
+    if (slot >= 0) {
+      if (pixelPool[slot].ptr) free(pixelPool[slot].ptr);
+      pixelPool[slot].ptr = p;
+      pixelPool[slot].len = len;
+      return;
+    }
+  }
+  free(p);
+}
+
+// frees all pooled buffers (segments were removed, their buffers are unlikely to be reused)
+static void flushPixelPool() {
+  SegmentBufferLock lock;
+  for (auto &entry : pixelPool) {
+    free(entry.ptr);
+    entry.ptr = nullptr;
+    entry.len = 0;
+  }
+}
+
+// allocates pixel buffer for current virtual dimensions (virtualWidth() x virtualHeight() or virtualLength() for 1D)
+// buffer holds unscaled colors, segment brightness is applied when the buffer is pushed to the strip in pushPixels()
+bool Segment::allocatePixels() {
+#ifdef WLED_DISABLE_SEGMENT_BUFFERS
+  return false;
+#else
+  if (!isActive() || !useSegmentBuffers) { deallocatePixels(); return false; }
+  unsigned len = virtualWidth() * virtualHeight();
+  if (!is2D()) len = std::max(len, (unsigned)virtualLength()); // 1D segments may be transposed or placed in matrix
+  SegmentBufferLock lock; // realtime data may be written to the buffer by UDP task
+  if (pixels && _pixelsLen == len) return true; // already allocated
+  deallocatePixels();
+  // segment will draw directly to the strip if buffer cannot be allocated
+  pixels = acquirePixelBuffer(len);
+  if (!pixels) { DEBUG_PRINTLN(F("!!! Pixel buffer allocation failed. !!!")); return false; }
+  memset(pixels, 0, len * sizeof(uint32_t));
+  _pixelsLen = len;
+  return true;
+#endif
+}
+
+void Segment::deallocatePixels() {
+  SegmentBufferLock lock;
+  releasePixelBuffer(pixels, _pixelsLen);
+  pixels = nullptr;
+  _pixelsLen = 0;
+}
+
 /**
   * If reset of this segment was requested, clears runtime
   * settings of this segment.
@@ -194,6 +498,7 @@ void Segment::resetIfRequired() {
   //DEBUG_PRINTF_P(PSTR("-- Segment reset: %p\n"), this);
   if (data && _dataLen > 0) memset(data, 0, _dataLen);  // prevent heap fragmentation (just erase buffer instead of deallocateData())
   next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0;
+  cost = 0; throttle = 0; // effect may have changed
   reset = false;
 }
 
@@ -264,14 +569,28 @@ void Segment::startTransition(uint16_t dur) {
   if (modeBlending) {
     swapSegenv(_t->_segT);
     _t->_modeT          = mode;
-    _t->_segT._dataLenT = 0;
-    _t->_segT._dataT    = nullptr;
-    if (_dataLen > 0 && data) {
-      _t->_segT._dataT = (byte *)malloc(_dataLen);
+    _t->_segT._dataLenT    = 0;
+    _t->_segT._dataT       = nullptr;
+    _t->_segT._dataHandleT = 0;
+    SegmentBufferLock lock; // effect data must not be moved while copying
+    if (_dataLen > 0 && data && Segment::getUsedSegmentData() + _dataLen <= MAX_SEGMENT_DATA) {
+      _t->_segT._dataHandleT = _dataArena.alloc(_dataLen);
+      _t->_segT._dataT = _dataArena.get(_t->_segT._dataHandleT);
       if (_t->_segT._dataT) {
         //DEBUG_PRINTF_P(PSTR("--  Allocated duplicate data (%d) for %p: %p\n"), _dataLen, this, _t->_segT._dataT);
-        memcpy(_t->_segT._dataT, data, _dataLen);
+        memcpy(_t->_segT._dataT, _dataArena.get(_dataHandle), _dataLen);
         _t->_segT._dataLenT = _dataLen;
+        Segment::addUsedSegmentData(_dataLen);
+      }
+    }
+    // old effect gets its own copy of pixel buffer so both effects can be rendered independently
+    _t->_segT._pixelsLenT = 0;
+    _t->_segT._pixelsT    = nullptr;
+    if (_pixelsLen > 0 && pixels) {
+      _t->_segT._pixelsT = acquirePixelBuffer(_pixelsLen);
+      if (_t->_segT._pixelsT) {
+        memcpy(_t->_segT._pixelsT, pixels, _pixelsLen * sizeof(uint32_t));
+        _t->_segT._pixelsLenT = _pixelsLen;
       }
     }
   } else {
@@ -288,10 +607,16 @@ void Segment::stopTransition() {
     #ifndef WLED_DISABLE_MODE_BLEND
     if (_t->_segT._dataT && _t->_segT._dataLenT > 0) {
       //DEBUG_PRINTF_P(PSTR("--  Released duplicate data (%d) for %p: %p\n"), _t->_segT._dataLenT, this, _t->_segT._dataT);
-      free(_t->_segT._dataT);
+      SegmentBufferLock lock;
+      _dataArena.release(_t->_segT._dataHandleT);
+      Segment::addUsedSegmentData(_t->_segT._dataLenT <= Segment::getUsedSegmentData() ? -_t->_segT._dataLenT : -Segment::getUsedSegmentData());
       _t->_segT._dataT = nullptr;
+      _t->_segT._dataHandleT = 0;
       _t->_segT._dataLenT = 0;
     }
+    releasePixelBuffer(_t->_segT._pixelsT, _t->_segT._pixelsLenT);
+    _t->_segT._pixelsT = nullptr;
+    _t->_segT._pixelsLenT = 0;
     #endif
     delete _t;
     _t = nullptr;
@@ -326,6 +651,9 @@ void Segment::swapSegenv(tmpsegd_t &tmpSeg) {
   tmpSeg._callT      = call;
   tmpSeg._dataT      = data;
   tmpSeg._dataLenT   = _dataLen;
+  tmpSeg._dataHandleT = _dataHandle;
+  tmpSeg._pixelsT    = pixels;
+  tmpSeg._pixelsLenT = _pixelsLen;
   if (_t && &tmpSeg != &(_t->_segT)) {
     // swap SEGENV with transitional data
     options   = _t->_segT._optionsT;
@@ -344,6 +672,12 @@ void Segment::swapSegenv(tmpsegd_t &tmpSeg) {
     call      = _t->_segT._callT;
     data      = _t->_segT._dataT;
     _dataLen  = _t->_segT._dataLenT;
+    _dataHandle = _t->_segT._dataHandleT;
+    if (_t->_segT._pixelsT) {
+      // old effect draws into its own buffer
+      pixels     = _t->_segT._pixelsT;
+      _pixelsLen = _t->_segT._pixelsLenT;
+    }
   }
 }
 
@@ -358,6 +692,12 @@ void Segment::restoreSegenv(tmpsegd_t &tmpSeg) {
     //if (_t->_segT._dataT != data) DEBUG_PRINTF_P(PSTR("---  data re-allocated: (%p) %p -> %p\n"), this, _t->_segT._dataT, data);
     _t->_segT._dataT = data;
     _t->_segT._dataLenT = _dataLen;
+    _t->_segT._dataHandleT = _dataHandle;
+    if (pixels != tmpSeg._pixelsT) {
+      // old effect was drawing into its own buffer (which may have been re-allocated)
+      _t->_segT._pixelsT    = pixels;
+      _t->_segT._pixelsLenT = _pixelsLen;
+    }
   }
   options   = tmpSeg._optionsT;
   for (size_t i=0; i<NUM_COLORS; i++) colors[i] = tmpSeg._colorT[i];
@@ -375,6 +715,9 @@ void Segment::restoreSegenv(tmpsegd_t &tmpSeg) {
   call      = tmpSeg._callT;
   data      = tmpSeg._dataT;
   _dataLen  = tmpSeg._dataLenT;
+  _dataHandle = tmpSeg._dataHandleT;
+  pixels    = tmpSeg._pixelsT;
+  _pixelsLen = tmpSeg._pixelsLenT;
 }
 #endif
 
@@ -411,6 +754,8 @@ void Segment::beginDraw() {
   _vHeight = virtualHeight();
   _vLength = virtualLength();
   _segBri  = currentBri();
+  _compileGeometry();
+  if (!allocatePixels()) BusManager::waitForOutput(); // make sure pixel buffer matches current geometry, without it segment draws to busses
   // adjust gamma for effects
   for (unsigned i = 0; i < NUM_COLORS; i++) {
     #ifndef WLED_DISABLE_MODE_BLEND
@@ -421,16 +766,46 @@ void Segment::beginDraw() {
     _currentColors[i] = gamma32(col);
   }
   // load palette into _currentPalette
-  loadPalette(_currentPalette, palette);
+  updatePaletteCache();
+}
+
+void Segment::updatePaletteCache() {
+  if (!_palCache && _isRGB && ESP.getFreeHeap() > MIN_HEAP_SIZE + sizeof(palcache_t)) {
+    _palCache = (palcache_t*)malloc(sizeof(palcache_t)); // if this fails color_from_palette() interpolates
+    if (_palCache) _palCache->valid = false;
+  }
   unsigned prog = progress();
-  if (strip.paletteFade && prog < 0xFFFFU) {
-    // blend palettes
-    // there are about 255 blend passes of 48 "blends" to completely blend two palettes (in _dur time)
-    // minimum blend time is 100ms maximum is 65535ms
-    unsigned noOfBlends = ((255U * prog) / 0xFFFFU) - _t->_prevPaletteBlends;
-    for (unsigned i = 0; i < noOfBlends; i++, _t->_prevPaletteBlends++) nblendPaletteTowardPalette(_t->_palT, _currentPalette, 48);
-    _currentPalette = _t->_palT; // copy transitioning/temporary palette
+  const bool fading = strip.paletteFade && prog < 0xFFFFU;
+  const float gamma = gammaCorrectCol ? gammaCorrectVal : 1.0f;
+  // random (1) and custom palettes (>245) may change without changing the id, only static palettes are reused
+  if (_palCache && _palCache->valid && !fading && _palCache->id == palette && _palCache->defaultId == _default_palette
+      && _palCache->gamma == gamma && palette != 1 && palette <= 245 && memcmp(_palCache->colors, colors, sizeof(colors)) == 0) {
+    _currentPalette = _palCache->pal;
+  } else {
+    loadPalette(_currentPalette, palette);
+    if (fading) {
+      // blend palettes
+      // there are about 255 blend passes of 48 "blends" to completely blend two palettes (in _dur time)
+      // minimum blend time is 100ms maximum is 65535ms
+      unsigned noOfBlends = ((255U * prog) / 0xFFFFU) - _t->_prevPaletteBlends;
+      for (unsigned i = 0; i < noOfBlends; i++, _t->_prevPaletteBlends++) nblendPaletteTowardPalette(_t->_palT, _currentPalette, 48);
+      _currentPalette = _t->_palT; // copy transitioning/temporary palette
+    }
+  }
+  if (!_palCache) return;
+
+  // rebuild LUT only if palette content or blending type changed
+  const bool noBlend = strip.paletteBlend == 3;
+  if (!_palCache->valid || _palCache->noBlend != noBlend || _palCache->pal != _currentPalette) {
+    for (unsigned i = 0; i < 256; i++) _palCache->lut[i] = ColorFromPalette(_currentPalette, i, 255, noBlend ? NOBLEND : LINEARBLEND);
+    _palCache->pal     = _currentPalette;
+    _palCache->noBlend = noBlend;
   }
+  _palCache->id        = palette;
+  _palCache->defaultId = _default_palette;
+  _palCache->gamma     = gamma;
+  memcpy(_palCache->colors, colors, sizeof(colors));
+  _palCache->valid     = !fading; // palette is not reused while fading
 }
 
 // relies on WS2812FX::service() to call it for each frame
@@ -474,6 +849,8 @@ void Segment::setGeometry(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, ui
     _vHeight = virtualHeight();
     _vLength = virtualLength();
     _segBri  = currentBri();
+    _compileGeometry();
+    deallocatePixels(); // buffer no longer matches geometry (will be re-allocated in beginDraw()), so clear directly on the strip
     fill(BLACK); // turn old segment range off or clears pixels if changing spacing (requires _vWidth/_vHeight/_vLength/_segBri)
   }
   if (grp) { // prevent assignment of 0
@@ -627,6 +1004,31 @@ unsigned Segment::virtualHeight() const {
   return vHeight;
 }
 
+// resolve reverse, transpose and grouping into origin and strides so that pixel expansion is a multiply-add
+void Segment::_compileGeometry() {
+  const int groupLen = groupLength();
+  const int len = length();
+  memset(&_geom, 0, sizeof(geom_t));
+  _geom.org  = start + (reverse ? (mirror ? (len - 1) / 2 : len - 1) : 0); // only need to index half the pixels if mirrored
+  _geom.step = reverse ? -groupLen : groupLen;
+#ifndef WLED_DISABLE_2D
+  // used by 2D segments and 1D segments that are part of the matrix
+  const int vW = virtualWidth();
+  const int vH = virtualHeight();
+  const int orgU = reverse   ? (vW - 1) * groupLen : 0; // along virtual x
+  const int orgV = reverse_y ? (vH - 1) * groupLen : 0; // along virtual y
+  const int stepU = reverse   ? -groupLen : groupLen;
+  const int stepV = reverse_y ? -groupLen : groupLen;
+  if (transpose) { // virtual x runs along physical Y
+    _geom.orgX = orgV; _geom.yX = stepV;
+    _geom.orgY = orgU; _geom.xY = stepU;
+  } else {
+    _geom.orgX = orgU; _geom.xX = stepU;
+    _geom.orgY = orgV; _geom.yY = stepV;
+  }
+#endif
+}
+
 // Constants for mapping mode "Pinwheel"
 #ifndef WLED_DISABLE_2D
 constexpr int Pinwheel_Steps_Small = 72;       // no holes up to 16x16
@@ -720,9 +1122,11 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col)
   if (is2D()) {
     const int vW = vWidth();   // segment width in logical pixels (can be 0 if segment is inactive)
     const int vH = vHeight();  // segment height in logical pixels (is always >= 1)
-    // pre-scale color for all pixels
-    col = color_fade(col, _segBri);
-    _colorScaled = true;
+    // pre-scale color for all pixels (buffered pixels are scaled in pushPixels())
+    if (!pixels) {
+      col = color_fade(col, _segBri);
+      _colorScaled = true;
+    }
     switch (map1D2D) {
       case M12_Pixels:
         // use all available pixels as a long strip
@@ -733,38 +1137,28 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col)
         if (vStrip > 0) setPixelColorXY(vStrip - 1, vH - i - 1, col);
         else for (int x = 0; x < vW; x++) setPixelColorXY(x, vH - i - 1, col);
         break;
-      case M12_pArc:
-        // expand in circular fashion from center
-        if (i == 0)
-          setPixelColorXY(0, 0, col);
-        else {
-          float r = i;
-          float step = HALF_PI / (2.8284f * r + 4); // we only need (PI/4)/(r/sqrt(2)+1) steps
-          for (float rad = 0.0f; rad <= (HALF_PI/2)+step/2; rad += step) {
-            int x = roundf(sin_t(rad) * r);
-            int y = roundf(cos_t(rad) * r);
-            // exploit symmetry
+      case M12_pArc: {
+        // expand in circular fashion from corner: ring i holds all pixels whose distance from corner rounds to i
+        // i.e. i*i - i < x*x + y*y <= i*i + i; rings partition the matrix so there are no gaps or overdraw
+        // walk the octant x <= y column by column (exploit symmetry), for each column ring i starts right after ring i-1
+        auto ringEnd = [](int r, int x) -> int { // largest y of ring r in column x (-1 if column is outside ring)
+          int v = r*r + r - x*x;
+          if (r < 0 || v < 0) return -1;
+          return v <= 0xFFFF ? sqrt16(v) : int(sqrtf(v));
+        };
+        for (int x = 0; ; x++) {
+          const int yHi = ringEnd(i, x);
+          if (yHi < x) break; // left the octant
+          const int yLo = std::max(ringEnd(i - 1, x) + 1, x);
+          for (int y = yLo; y <= yHi; y++) {
             setPixelColorXY(x, y, col);
-            setPixelColorXY(y, x, col);
+            if (x != y) setPixelColorXY(y, x, col);
           }
-          // Bresenham’s Algorithm (may not fill every pixel)
-          //int d = 3 - (2*i);
-          //int y = i, x = 0;
-          //while (y >= x) {
-          //  setPixelColorXY(x, y, col);
-          //  setPixelColorXY(y, x, col);
-          //  x++;
-          //  if (d > 0) {
-          //    y--;
-          //    d += 4 * (x - y) + 10;
-          //  } else {
-          //    d += 4 * x + 6;
-          //  }
-          //}
         }
         break;
+      }
       case M12_pCorner:
-        for (int x = 0; x <= i; x++) setPixelColorXY(x, i, col);
+        setPixelSpanXY(i, 0, i, col); // row i up to and including the corner
         for (int y = 0; y <  i; y++) setPixelColorXY(i, y, col);
         break;
       case M12_sPinwheel: {
@@ -828,20 +1222,26 @@ void IRAM_ATTR_YN Segment::setPixelColor(int i, uint32_t col)
   }
 #endif
 
-  unsigned len = length();
+  if (pixels) {
+    if (unsigned(i) >= _pixelsLen) return; // safety check (beginDraw() not called)
+#ifndef WLED_DISABLE_MODE_BLEND
+    if (_modeBlend) col = color_blend16(pixels[i], col, uint16_t(0xFFFFU - progress()));
+#endif
+    pixels[i] = col;
+    return;
+  }
+
   // if color is unscaled
   if (!_colorScaled) col = color_fade(col, _segBri);
+  _expandPixel(i, col);
+}
 
-  // expand pixel (taking into account start, grouping, spacing [and offset])
-  i = i * groupLength();
-  if (reverse) { // is segment reversed?
-    if (mirror) { // is segment mirrored?
-      i = (len - 1) / 2 - i;  //only need to index half the pixels
-    } else {
-      i = (len - 1) - i;
-    }
-  }
-  i += start; // starting pixel in a group
+// expand virtual pixel onto the strip (taking into account start, grouping, spacing [and offset])
+// color must already be scaled by segment brightness
+void IRAM_ATTR_YN Segment::_expandPixel(int i, uint32_t col)
+{
+  unsigned len = length();
+  i = _geom.org + i * _geom.step; // starting pixel in a group
 
   uint32_t tmpCol = col;
   // set all the pixels in the group
@@ -962,6 +1362,8 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColor(int i) const
   }
 #endif
 
+  if (pixels) return unsigned(i) < _pixelsLen ? pixels[i] : 0;
+
   if (reverse) i = vLength() - i - 1;
   i *= groupLength();
   i += start;
@@ -971,6 +1373,85 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColor(int i) const
   return strip.getPixelColor(i);
 }
 
+#ifndef WLED_DISABLE_MODE_BLEND
+// combines old and new effect pixel (from separate buffers of width w) at x,y according to transition style
+static uint32_t transitionPixel(const uint32_t *oldPx, const uint32_t *newPx, unsigned x, unsigned y, unsigned w, unsigned prog, uint8_t style) {
+  const unsigned idx = y * w + x;
+  switch (style) {
+    case BLEND_STYLE_WIPE: // new effect is revealed from the start of segment
+      return (x * 0xFFFFU < prog * w) ? newPx[idx] : oldPx[idx];
+    case BLEND_STYLE_PUSH: { // new effect pushes old effect out of segment
+      unsigned cut = (prog * w) >> 16;
+      return (x < cut) ? newPx[y * w + w - cut + x] : oldPx[idx - cut];
+    }
+    case BLEND_STYLE_DISSOLVE: // pixels switch to new effect in pseudo-random order
+      return (((idx * 2654435761U) >> 16) & 0xFFFFU) < prog ? newPx[idx] : oldPx[idx];
+    default: // BLEND_STYLE_FADE
+      return color_blend16(oldPx[idx], newPx[idx], prog);
+  }
+}
+#endif
+
+// compositing pass: expand pixel buffer (in virtual coordinates) onto the strip
+// if strip has a compositing buffer pixels are blended as a layer (segment opacity is layer alpha)
+// otherwise they are scaled by segment brightness and drawn directly
+// also restores drawing parameters (_vWidth, _vHeight, _vLength) as buffer may be pushed for any segment
+void Segment::pushPixels() {
+  if (!isActive() || !pixels) return;
+  updateTransitionProgress();
+  _vWidth  = virtualWidth();
+  _vHeight = virtualHeight();
+  _vLength = virtualLength();
+  _compileGeometry();
+  const uint8_t bri = currentBri();
+  const bool asLayer = strip._pixels != nullptr;
+  if (asLayer) {
+    if (bri == 0) return; // fully transparent layer
+    strip._layerBlendMode = blendMode;
+    strip._layerOpacity   = bri;
+    strip._compositing    = true;
+  }
+  const uint8_t scale = asLayer ? 255 : bri; // color_fade() is a no-op for 255
+  // 2D segments and 1D segments that are part of the matrix store pixels in XY layout (w x h)
+  // other 1D segments are a single row
+  bool useXY = false;
+  unsigned w = _vLength;
+  unsigned h = 1;
+#ifndef WLED_DISABLE_2D
+  if (is2D() || (Segment::maxHeight != 1 && (width() == 1 || height() == 1) && start < Segment::maxWidth*Segment::maxHeight)) {
+    useXY = true;
+    w = _vWidth;
+    h = _vHeight;
+  }
+#endif
+  if (w * h > _pixelsLen) { // geometry changed, wait for beginDraw() to re-allocate
+    if (useXY) { strip._compositing = false; return; }
+    w = _pixelsLen;
+  }
+  // old effect buffer (if effects are rendered separately)
+#ifndef WLED_DISABLE_MODE_BLEND
+  const uint32_t *oldPixels = nullptr;
+  const unsigned prog = progress();
+  if (modeBlending && isTransitionBuffered() && prog < 0xFFFFU && _t->_modeT != mode && _t->_segT._pixelsLenT == _pixelsLen) oldPixels = _t->_segT._pixelsT;
+#endif
+  for (unsigned y = 0; y < h; y++) {
+    for (unsigned x = 0; x < w; x++) {
+#ifndef WLED_DISABLE_MODE_BLEND
+      uint32_t col = oldPixels ? transitionPixel(oldPixels, pixels, x, y, w, prog, blendingStyle) : pixels[y * w + x];
+#else
+      uint32_t col = pixels[y * w + x];
+#endif
+      col = color_fade(col, scale);
+#ifndef WLED_DISABLE_2D
+      if (useXY) _expandPixelXY(x, y, col);
+      else
+#endif
+      _expandPixel(x, col);
+    }
+  }
+  strip._compositing = false;
+}
+
 uint8_t Segment::differs(const Segment& b) const {
   uint8_t d = 0;
   if (start != b.start)         d |= SEG_DIFFERS_BOUNDS;
@@ -979,6 +1460,7 @@ uint8_t Segment::differs(const Segment& b) const {
   if (grouping != b.grouping)   d |= SEG_DIFFERS_GSO;
   if (spacing != b.spacing)     d |= SEG_DIFFERS_GSO;
   if (opacity != b.opacity)     d |= SEG_DIFFERS_BRI;
+  if (blendMode != b.blendMode) d |= SEG_DIFFERS_OPT;
   if (mode != b.mode)           d |= SEG_DIFFERS_FX;
   if (speed != b.speed)         d |= SEG_DIFFERS_FX;
   if (intensity != b.intensity) d |= SEG_DIFFERS_FX;
@@ -1053,13 +1535,28 @@ void Segment::fill(uint32_t c) {
   if (!isActive()) return; // not active
   const int cols = is2D() ? vWidth() : vLength();
   const int rows = vHeight(); // will be 1 for 1D
+#ifndef WLED_DISABLE_MODE_BLEND
+  if (pixels && !_modeBlend) {
+#else
+  if (pixels) {
+#endif
+    // buffered segment: no mapping needed, fill the whole buffer
+    for (unsigned i = 0; i < _pixelsLen; i++) pixels[i] = c;
+    return;
+  }
+  if (is2D()) {
+    for (int y = 0; y < rows; y++) setPixelSpanXY(y, 0, cols - 1, c); // span writer scales color once per row
+    return;
+  }
+  if (pixels) {
+    // old effect blending into shared buffer: buffer holds unscaled colors
+    for (int x = 0; x < cols; x++) setPixelColor(x, c);
+    return;
+  }
   // pre-scale color for all pixels
   c = color_fade(c, _segBri);
   _colorScaled = true;
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    if (is2D()) setPixelColorXY(x, y, c);
-    else        setPixelColor(x, c);
-  }
+  for (int x = 0; x < cols; x++) setPixelColor(x, c);
   _colorScaled = false;
 }
 
@@ -1080,8 +1577,12 @@ void Segment::fade_out(uint8_t rate) {
   int g2 = G(color);
   int b2 = B(color);
 
-  for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
-    color = is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
+  // buffered segment: operate directly on buffer (layout is irrelevant as all pixels are processed)
+  const unsigned len = pixels ? _pixelsLen : cols * rows;
+  for (unsigned i = 0; i < len; i++) {
+    const int x = pixels ? i : i % cols;
+    const int y = pixels ? 0 : i / cols;
+    color = pixels ? pixels[i] : is2D() ? getPixelColorXY(x, y) : getPixelColor(x);
     if (color == colors[1]) continue; // already at target color
     int w1 = W(color);
     int r1 = R(color);
@@ -1099,8 +1600,9 @@ void Segment::fade_out(uint8_t rate) {
     gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
     bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
 
-    if (is2D()) setPixelColorXY(x, y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
-    else        setPixelColor(x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    if (pixels)      pixels[i] = RGBW32(r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    else if (is2D()) setPixelColorXY(x, y, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+    else             setPixelColor(x, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
   }
 }
 
@@ -1110,48 +1612,134 @@ void Segment::fadeToBlackBy(uint8_t fadeBy) {
   const int cols = is2D() ? vWidth() : vLength();
   const int rows = vHeight(); // will be 1 for 1D
 
+  if (pixels) {
+    for (unsigned i = 0; i < _pixelsLen; i++) pixels[i] = color_fade(pixels[i], 255-fadeBy);
+    return;
+  }
   for (int y = 0; y < rows; y++) for (int x = 0; x < cols; x++) {
     if (is2D()) setPixelColorXY(x, y, color_fade(getPixelColorXY(x,y), 255-fadeBy));
     else        setPixelColor(x, color_fade(getPixelColor(x), 255-fadeBy));
   }
 }
 
+// returns scratch memory for blurring (at least len pixels), nullptr if out of memory
+uint32_t *Segment::_getBlurRow(unsigned len) {
+  if (len > _blurRowLen) {
+    _freeBlurRow(); // contents need not be preserved
+    if (ESP.getFreeHeap() < MIN_HEAP_SIZE + len * sizeof(uint32_t)) return nullptr;
+    _blurRow = (uint32_t*)malloc(len * sizeof(uint32_t));
+    _blurRowLen = _blurRow ? len : 0;
+  }
+  return _blurRow;
+}
+
+// frees scratch row if it is larger than BLUR_ROW_KEEP pixels (or always if force is set)
+void Segment::_freeBlurRow(bool force) {
+  if (!force && _blurRowLen <= BLUR_ROW_KEEP) return;
+  free(_blurRow);
+  _blurRow = nullptr;
+  _blurRowLen = 0;
+}
+
+// packed RGBW arithmetic: R & B (and W & G) are processed together as two 16 bit lanes of one 32 bit word
+#define BLUR_LANE_RB(c) ((c) & 0x00FF00FFU)
+#define BLUR_LANE_WG(c) (((c) >> 8) & 0x00FF00FFU)
+
+/*
+ * blurs a single line of pixels: src[0..len-1] is read, result is written to dst[i*stride]
+ * BLUR_GAUSS uses src[len..2*len-1] as intermediate buffer for multiple passes; src must not overlap dst
+ * BLUR_SMEAR: source: FastLED colorutils.cpp; for amount > 215 this kernel does not work properly (creates alternating pattern)
+ */
+void IRAM_ATTR_YN Segment::_blurLine(uint32_t *dst, unsigned stride, uint32_t *src, unsigned len, uint8_t kernel, uint8_t amount, bool smear) {
+  if (len < 2) return;
+  const unsigned last = len - 1;
+  switch (kernel) {
+    case BLUR_BOX: {
+      // moving sum over window [i-r, i+r] with edge pixels repeated; division by window size uses exact 16.16 reciprocal
+      const unsigned r = constrain(amount, 1, 3);
+      const unsigned d = 2*r + 1;
+      const uint32_t recip = (65535U + d) / d; // ceil(65536/d): floor(sum*recip >> 16) == sum/d for sum <= 255*d
+      uint32_t sumRB = 0, sumWG = 0;
+      for (int k = -int(r); k <= int(r); k++) {
+        uint32_t c = src[constrain(k, 0, int(last))];
+        sumRB += BLUR_LANE_RB(c);
+        sumWG += BLUR_LANE_WG(c);
+      }
+      for (unsigned i = 0; i < len; i++) {
+        dst[i * stride] = RGBW32(((sumRB >> 16) * recip) >> 16, ((sumWG & 0xFFFF) * recip) >> 16, ((sumRB & 0xFFFF) * recip) >> 16, ((sumWG >> 16) * recip) >> 16);
+        uint32_t cIn  = src[std::min(i + r + 1, last)];
+        uint32_t cOut = src[i < r ? 0 : i - r];
+        sumRB += BLUR_LANE_RB(cIn) - BLUR_LANE_RB(cOut); // lanes can not underflow as cOut is part of the sum
+        sumWG += BLUR_LANE_WG(cIn) - BLUR_LANE_WG(cOut);
+      }
+    } break;
+    case BLUR_GAUSS: {
+      // each [1 2 1] pass widens the kernel (1 pass: 3 taps, 2 passes: 5 taps [1 4 6 4 1], 3 passes: 7 taps)
+      const unsigned passes = constrain(amount, 1, 3);
+      uint32_t *tmp = src + len;
+      for (unsigned p = 0; p < passes; p++) {
+        const uint32_t *in = (p & 1) ? tmp : src;
+        uint32_t *out      = (p == passes - 1) ? dst : (p & 1) ? src : tmp;
+        const unsigned step = (p == passes - 1) ? stride : 1;
+        uint32_t prev = in[0];
+        for (unsigned i = 0; i < len; i++) {
+          uint32_t cur  = in[i];
+          uint32_t next = in[std::min(i + 1, last)];
+          uint32_t rb = BLUR_LANE_RB(prev) + 2*BLUR_LANE_RB(cur) + BLUR_LANE_RB(next);
+          uint32_t wg = BLUR_LANE_WG(prev) + 2*BLUR_LANE_WG(cur) + BLUR_LANE_WG(next);
+          out[i * step] = ((rb >> 2) & 0x00FF00FFU) | ((wg << 6) & 0xFF00FF00U);
+          prev = cur;
+        }
+      }
+    } break;
+    default: {
+      const uint8_t keep = smear ? 255 : 255 - amount;
+      const uint8_t seep = amount >> 1;
+      uint32_t prevPart = BLACK;
+      uint32_t curPart  = color_fade(src[0], seep);
+      for (unsigned i = 0; i < len; i++) {
+        uint32_t nextPart = i < last ? color_fade(src[i + 1], seep) : BLACK;
+        uint32_t c = color_fade(src[i], keep);
+        if (prevPart) c = color_add(c, prevPart);
+        if (nextPart) c = color_add(c, nextPart);
+        dst[i * stride] = c;
+        prevPart = curPart;
+        curPart  = nextPart;
+      }
+    } break;
+  }
+}
+
 /*
- * blurs segment content, source: FastLED colorutils.cpp
- * Note: for blur_amount > 215 this function does not work properly (creates alternating pattern)
+ * blurs segment content using selected kernel (see BLUR_SMEAR, BLUR_BOX, BLUR_GAUSS)
+ * amount is blur amount for BLUR_SMEAR and radius for other kernels
  */
-void Segment::blur(uint8_t blur_amount, bool smear) {
+void Segment::blur(uint8_t blur_amount, bool smear, uint8_t kernel) {
   if (!isActive() || blur_amount == 0) return; // optimization: 0 means "don't blur"
 #ifndef WLED_DISABLE_2D
   if (is2D()) {
     // compatibility with 2D
-    blur2D(blur_amount, blur_amount, smear); // symmetrical 2D blur
-    //box_blur(map(blur_amount,1,255,1,3), smear);
+    blur2D(blur_amount, blur_amount, smear, kernel); // symmetrical 2D blur
     return;
   }
 #endif
-  uint8_t keep = smear ? 255 : 255 - blur_amount;
-  uint8_t seep = blur_amount >> 1;
   unsigned vlength = vLength();
-  uint32_t carryover = BLACK;
-  uint32_t lastnew;
-  uint32_t last;
-  uint32_t curnew = BLACK;
-  for (unsigned i = 0; i < vlength; i++) {
-    uint32_t cur = getPixelColor(i);
-    uint32_t part = color_fade(cur, seep);
-    curnew = color_fade(cur, keep);
-    if (i > 0) {
-      if (carryover) curnew = color_add(curnew, carryover);
-      uint32_t prev = color_add(lastnew, part);
-      // optimization: only set pixel if color has changed
-      if (last != prev) setPixelColor(i - 1, prev);
-    } else setPixelColor(i, curnew); // first pixel
-    lastnew = curnew;
-    last = cur; // save original value for comparison on next iteration
-    carryover = part;
-  }
-  setPixelColor(vlength - 1, curnew);
+  if (pixels && vlength > _pixelsLen) vlength = _pixelsLen;
+  if (vlength < 2) return;
+  const unsigned srcLen = (kernel == BLUR_GAUSS ? 2 : 1) * vlength; // gauss needs an intermediate line
+  uint32_t *row = _getBlurRow(srcLen + (pixels ? 0 : vlength));
+  if (!row) return; // not enough memory
+  if (pixels) {
+    // buffered segment: blur directly into buffer
+    memcpy(row, pixels, vlength * sizeof(uint32_t));
+    _blurLine(pixels, 1, row, vlength, kernel, blur_amount, smear);
+  } else {
+    uint32_t *out = row + srcLen;
+    for (unsigned i = 0; i < vlength; i++) row[i] = getPixelColor(i);
+    _blurLine(out, 1, row, vlength, kernel, blur_amount, smear);
+    for (unsigned i = 0; i < vlength; i++) setPixelColor(i, out[i]);
+  }
+  _freeBlurRow();
 }
 
 /*
@@ -1195,7 +1783,19 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   if (mapping && vL > 1) paletteIndex = (i*255)/(vL -1);
   // paletteBlend: 0 - wrap when moving, 1 - always wrap, 2 - never wrap, 3 - none (undefined)
   if (!wrap && strip.paletteBlend != 3) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
-  CRGBW palcol = ColorFromPalette(_currentPalette, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+  CRGBW palcol;
+  if (_palCache) {
+    // expanded palette is built in beginDraw()
+    palcol = _palCache->lut[paletteIndex & 0xFF];
+    if (pbri < 255) {
+      uint32_t scale = pbri + 1; // same rounding as ColorFromPaletteWLED()
+      palcol.r = (palcol.r * scale) >> 8;
+      palcol.g = (palcol.g * scale) >> 8;
+      palcol.b = (palcol.b * scale) >> 8;
+    }
+  } else {
+    palcol = ColorFromPalette(_currentPalette, paletteIndex, pbri, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND); // NOTE: paletteBlend should be global
+  }
   palcol.w = W(color);
 
   return palcol.color32;
@@ -1211,6 +1811,9 @@ void WS2812FX::finalizeInit() {
   //reset segment runtimes
   restartRuntime();
 
+  // reserve (small) effect data arena early while heap is not yet fragmented, larger effect data uses the heap
+  Segment::getDataArena().begin(DATA_ARENA_SIZE);
+
   // for the lack of better place enumerate ledmaps here
   // if we do it in json.cpp (serializeInfo()) we are getting flashes on LEDs
   // unfortunately this means we do not get updates after uploads
@@ -1320,6 +1923,7 @@ void WS2812FX::finalizeInit() {
 
   Segment::maxWidth  = _length;
   Segment::maxHeight = 1;
+  BusManager::updateRouting(); // buses are final
 
   //segments are created in makeAutoSegments();
   DEBUG_PRINTLN(F("Loading custom palettes"));
@@ -1342,7 +1946,16 @@ void WS2812FX::service() {
   bool doShow = false;
 
   _isServicing = true;
+  if (_suspend) { _isServicing = false; return; } // segments are being changed
+
+  // close gaps in effect data left by released buffers (no effect is running, so data can be moved)
+  {
+    SegmentBufferLock lock;
+    if (Segment::getDataArena().compact()) for (segment &seg : _segments) seg.refreshData();
+  }
+
   _segment_index = 0;
+  uint32_t load = 0; // effect time of this frame
 
   for (segment &seg : _segments) {
     if (_suspend) return; // immediately stop processing segments if suspend requested during service()
@@ -1357,7 +1970,7 @@ void WS2812FX::service() {
     // last condition ensures all solid segments are updated at the same time
     if (nowUp >= seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
     {
-      doShow = true;
+      if (!seg.freeze || !realtimeMode) doShow = true; // frames of frozen live segment are shown by showRealtime()
       unsigned frameDelay = FRAMETIME;
 
       if (!seg.freeze) { //only run effect function if not frozen
@@ -1369,33 +1982,45 @@ void WS2812FX::service() {
         // Effect blending
         // When two effects are being blended, each may have different segment data, this
         // data needs to be saved first and then restored before running previous mode.
-        // The blending will largely depend on the effect behaviour since actual output (LEDs) may be
-        // overwritten by later effect. To enable seamless blending for every effect, additional LED buffer
-        // would need to be allocated for each effect and then blended together for each pixel.
+        // If segment has pixel buffers for both effects each effect renders into its own buffer and the two
+        // are combined in pushPixels() using selected blending style. Otherwise the old effect blends
+        // into the shared buffer/LEDs and the result will largely depend on the effect behaviour.
         [[maybe_unused]] uint8_t tmpMode = seg.currentMode();  // this will return old mode while in transition
+        const unsigned long segStart = micros();
+        unsigned long start = segStart;
         seg.beginDraw();                      // set up parameters for get/setPixelColor()
         frameDelay = (*_mode[seg.mode])();    // run new/current mode
+        PerfMonitor::effect[_segment_index].add(micros() - start);
 #ifndef WLED_DISABLE_MODE_BLEND
         if (modeBlending && seg.mode != tmpMode) {
+          start = micros();
           Segment::tmpsegd_t _tmpSegData;
-          Segment::modeBlend(true);           // set semaphore
+          Segment::modeBlend(!seg.isTransitionBuffered()); // set semaphore (only needed if effects share buffer)
           seg.swapSegenv(_tmpSegData);        // temporarily store new mode state (and swap it with transitional state)
           seg.beginDraw();                    // set up parameters for get/setPixelColor()
           unsigned d2 = (*_mode[tmpMode])();  // run old mode
           seg.restoreSegenv(_tmpSegData);     // restore mode state (will also update transitional state)
           frameDelay = min(frameDelay,d2);              // use shortest delay
           Segment::modeBlend(false);          // unset semaphore
+          PerfMonitor::blend.add(micros() - start);
         }
 #endif
         seg.call++;
         if (seg.isInTransition() && frameDelay > FRAMETIME) frameDelay = FRAMETIME; // force faster updates during transition
         BusManager::setSegmentCCT(oldCCT); // restore old CCT for ABL adjustments
+        const uint32_t elapsedSeg = micros() - segStart;
+        seg.cost = seg.cost ? (seg.cost * 7 + elapsedSeg) / 8 : elapsedSeg;
+        load += elapsedSeg;
+        if (!seg.isInTransition()) frameDelay += seg.throttle * _frametime; // throttled segment skips frames (except in transition)
       }
 
       seg.next_time = nowUp + frameDelay;
     }
     _segment_index++;
   }
+
+  if (doShow) scheduleSegments(load);
+  if (doShow && !_suspend) compositeSegments();
   _isServicing = false;
   _triggered = false;
 
@@ -1413,12 +2038,141 @@ void WS2812FX::service() {
   #endif
 }
 
+// frame budget scheduler: if effects use more than their share of frame time, the segment with the most expensive
+// effect (that contributes significantly to the load) skips frames; cheap segments keep their update rate
+// when there is enough headroom again, throttling is released starting with the cheapest throttled segment
+void WS2812FX::scheduleSegments(uint32_t load) {
+  _frameLoad = _frameLoad ? (_frameLoad * 7 + load) / 8 : load;
+  if (_schedHold) { _schedHold--; return; }
+  const uint32_t budget = getFrameBudget();
+  segment *pick = nullptr;
+  if (budget && _frameLoad > budget) {
+    for (segment &seg : _segments) {
+      if (!seg.isActive() || seg.freeze || seg.throttle >= FRAME_BUDGET_MAX_THROTTLE) continue;
+      if (seg.cost * 4 < _frameLoad) continue; // cheap segment (less than 25% of load)
+      if (!pick || seg.cost > pick->cost) pick = &seg;
+    }
+    if (pick) {
+      pick->throttle++;
+      DEBUG_PRINTF_P(PSTR("Frame budget %u/%uus, throttling segment %d to 1/%d.\n"), (unsigned)_frameLoad, (unsigned)budget, int(pick - &_segments[0]), pick->throttle + 1);
+    }
+  } else if (!budget || _frameLoad < budget - budget / 3) {
+    for (segment &seg : _segments) {
+      if (!seg.throttle) continue;
+      if (!pick || seg.cost < pick->cost) pick = &seg;
+    }
+    if (pick) pick->throttle--;
+  }
+  if (pick) _schedHold = FRAME_BUDGET_HOLD; // let moving averages settle
+}
+
+// calls fn(index) for each logical pixel of the segment's bounding area (one row range per matrix row or a single 1D range)
+template<typename F> static void forEachSegmentPixel(const Segment &seg, unsigned maxLen, F fn) {
+  const unsigned matrixSize = Segment::maxWidth * Segment::maxHeight;
+  const bool inMatrix = seg.start < matrixSize; // segments after the matrix are plain 1D ranges
+  const unsigned firstRow = inMatrix ? seg.startY : 0;
+  const unsigned lastRow  = inMatrix ? seg.stopY  : 1;
+  for (unsigned y = firstRow; y < lastRow; y++) {
+    const unsigned rowStart = inMatrix ? y * Segment::maxWidth : 0;
+    const unsigned end = std::min(rowStart + seg.stop, maxLen);
+    for (unsigned i = rowStart + seg.start; i < end; i++) fn(i);
+  }
+}
+
+// compositing pass: blend buffered segments (in segment order, later segments on top) into strip buffer
+// using their blend mode and opacity, then push covered pixels to busses
+// segments without pixel buffer have already drawn directly to busses and will be covered by layers
+void WS2812FX::compositeSegments() {
+  SegmentBufferLock lock; // realtime data may be written to main segment buffer by UDP task
+  const unsigned len = getLengthTotal();
+  bool buffered = false;
+  for (const segment &seg : _segments) buffered |= seg.isActive() && seg.pixels;
+  if (!buffered || _pixelsLen != len) {
+    if (_pixels) free(_pixels);
+    _pixels = nullptr;
+    _pixelsLen = 0;
+    if (!buffered) return; // all segments have drawn directly to busses
+    // leave enough heap for web server, if this fails segments are drawn directly (see Segment::pushPixels())
+    if (ESP.getFreeHeap() >= MIN_HEAP_SIZE + len * sizeof(uint32_t)) _pixels = (uint32_t*)malloc(len * sizeof(uint32_t));
+    _pixelsLen = _pixels ? len : 0;
+  }
+  BusManager::waitForOutput(); // previous frame must be sent before busses are written (rendering into segment buffers overlaps it)
+  int oldCCT = BusManager::getSegmentCCT(); // store original CCT value (actually it is not Segment based)
+  unsigned long start = micros();
+
+  if (_pixels) {
+    // layers are blended over black
+    for (const segment &seg : _segments) {
+      if (!seg.isActive() || !seg.pixels) continue;
+      forEachSegmentPixel(seg, _pixelsLen, [this](unsigned i) { _pixels[i] = BLACK; });
+    }
+  }
+  for (segment &seg : _segments) {
+    if (!seg.isActive() || !seg.pixels) continue;
+    seg.updateTransitionProgress();
+    // CCT is applied when pixels are sent to busses
+    if (cctFromRgb) BusManager::setSegmentCCT(-1);
+    else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
+    seg.pushPixels();
+  }
+  PerfMonitor::blend.add(micros() - start);
+  if (_pixels) {
+    start = micros();
+    for (segment &seg : _segments) {
+      if (!seg.isActive() || !seg.pixels) continue;
+      seg.updateTransitionProgress();
+      if (cctFromRgb) BusManager::setSegmentCCT(-1);
+      else            BusManager::setSegmentCCT(seg.currentBri(true), correctWB);
+      forEachSegmentPixel(seg, _pixelsLen, [this](unsigned i) {
+        unsigned pix = getMappedPixelIndex(i);
+        if (pix < _length) BusManager::setPixelColor(pix, _pixels[i]);
+      });
+    }
+    PerfMonitor::busFill.add(micros() - start);
+  }
+  BusManager::setSegmentCCT(oldCCT);
+}
+
 void IRAM_ATTR WS2812FX::setPixelColor(unsigned i, uint32_t col) {
+  if (_compositing) {
+    // blending segment layer into strip buffer (ledmap is applied when buffer is pushed to busses)
+    if (i < _pixelsLen) {
+      if (_layerBlendMode != BLEND_MODE_NORMAL) col = color_blend_mode(_pixels[i], col, _layerBlendMode);
+      _pixels[i] = (_layerOpacity == 255) ? col : color_blend(_pixels[i], col, _layerOpacity);
+    }
+    return;
+  }
   i = getMappedPixelIndex(i);
   if (i >= _length) return;
   BusManager::setPixelColor(i, col);
 }
 
+// bulk version of setPixelColor(), resolves buses once per run of pixels (using coalesced ledmap runs if ledmap is in use)
+void WS2812FX::setPixelColors(unsigned i, const uint32_t *c, unsigned count) {
+  const bool ledmap = isLedMapActive();
+  if (_compositing || (ledmap && _routes.empty())) {
+    for (unsigned n = 0; n < count; n++) setPixelColor(i + n, c[n]);
+    return;
+  }
+  if (ledmap) {
+    BusManager::waitForOutput(); // bus pixels are written directly
+    const unsigned end = i + count;
+    // first run that ends after i
+    auto r = std::upper_bound(_routes.begin(), _routes.end(), i, [](unsigned v, const route_t &rt) { return v < unsigned(rt.index + rt.count); });
+    for (; r != _routes.end() && r->index < end; ++r) {
+      Bus *bus = BusManager::getBus(r->bus);
+      if (!bus) break; // buses are being re-created
+      const unsigned first = max(i, unsigned(r->index));
+      const unsigned last  = min(end, unsigned(r->index + r->count));
+      for (unsigned p = first; p < last; p++) bus->setPixelColor(r->local + p - r->index, c[p - i]);
+    }
+    return;
+  }
+  if (i >= _length) return;
+  if (count > _length - i) count = _length - i;
+  BusManager::setPixelColors(i, c, count);
+}
+
 uint32_t IRAM_ATTR WS2812FX::getPixelColor(unsigned i) const {
   i = getMappedPixelIndex(i);
   if (i >= _length) return 0;
@@ -1428,13 +2182,22 @@ uint32_t IRAM_ATTR WS2812FX::getPixelColor(unsigned i) const {
 void WS2812FX::show() {
   // avoid race condition, capture _callback value
   show_callback callback = _callback;
-  if (callback) callback();
+  if (callback) {
+    BusManager::waitForOutput(); // overlays draw directly into bus buffers
+    callback();
+  }
   unsigned long showNow = millis();
 
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
+  // with WLED_ENABLE_OUTPUT_TASK buses are sent on the other core and only the handover is measured
+  unsigned long start = micros();
   BusManager::show();
+  PerfMonitor::show.add(micros() - start);
+  #ifdef WLED_OUTPUT_TASK
+  PerfMonitor::outWait.add(BusManager::takeOutputWait()); // time this frame was blocked by previous one being sent
+  #endif
 
   size_t diff = showNow - _lastShow;
 
@@ -1445,6 +2208,13 @@ void WS2812FX::show() {
   }
 }
 
+// realtime frames are shown outside of service(), in main segment only mode the data was written into the
+// (frozen) main segment's buffer and has to be composited first or the busses would show the previous frame
+void WS2812FX::showRealtime() {
+  if (useMainSegmentOnly && !_suspend) compositeSegments();
+  show();
+}
+
 void WS2812FX::setTargetFps(unsigned fps) {
   if (fps <= 250) _targetFps = fps;
   if (_targetFps > 0) _frametime = 1000 / _targetFps;
@@ -1559,6 +2329,7 @@ bool WS2812FX::hasCCTBus() const {
 }
 
 void WS2812FX::purgeSegments() {
+  StateLock stateLock; // async web server task may be serializing segments
   // remove all inactive segments (from the back)
   int deleted = 0;
   if (_segments.size() <= 1) return;
@@ -1570,6 +2341,7 @@ void WS2812FX::purgeSegments() {
   if (deleted) {
     _segments.shrink_to_fit();
     setMainSegmentId(0);
+    flushPixelPool();
   }
 }
 
@@ -1578,7 +2350,9 @@ Segment& WS2812FX::getSegment(unsigned id) {
 }
 
 void WS2812FX::resetSegments() {
+  StateLock stateLock; // async web server task may be serializing segments
   _segments.clear(); // destructs all Segment as part of clearing
+  flushPixelPool();
   #ifndef WLED_DISABLE_2D
   segment seg = isMatrix ? Segment(0, Segment::maxWidth, 0, Segment::maxHeight) : Segment(0, _length);
   #else
@@ -1781,13 +2555,28 @@ bool WS2812FX::deserializeMap(unsigned n) {
   char fileName[32];
   strcpy_P(fileName, PSTR("/ledmap"));
   if (n) sprintf(fileName +7, "%d", n);
-  strcat_P(fileName, PSTR(".json"));
-  bool isFile = WLED_FS.exists(fileName);
+  char *ext = fileName + strlen(fileName);
+  strcpy_P(ext, PSTR(".bin")); // binary ledmap takes precedence
+  bool isBin = WLED_FS.exists(fileName);
+  if (!isBin) strcpy_P(ext, PSTR(".json"));
+  bool isFile = isBin || WLED_FS.exists(fileName);
 
   customMappingSize = 0; // prevent use of mapping if anything goes wrong
   currentLedmap = 0;
   if (n == 0 || isFile) interfaceUpdateCallMode = CALL_MODE_WS_SEND; // schedule WS update (to inform UI)
 
+  if (isBin) {
+    if (deserializeMapBin(fileName, n)) {
+      currentLedmap = n;
+      updateRoutes();
+      return true;
+    }
+    DEBUG_PRINT(F("ERROR Invalid ledmap in ")); DEBUG_PRINTLN(fileName);
+    customMappingSize = 0;
+    strcpy_P(ext, PSTR(".json")); // fall back to JSON ledmap
+    isFile = WLED_FS.exists(fileName);
+  }
+
   if (!isFile && n==0 && isMatrix) {
     setUpMatrix();
     return false;
@@ -1824,9 +2613,81 @@ bool WS2812FX::deserializeMap(unsigned n) {
   }
 
   releaseJSONBufferLock();
+  updateRoutes();
   return (customMappingSize > 0);
 }
 
+// load binary ledmap (see ledmap_bin_t): map is streamed into customMappingTable, JSON buffer is not used
+bool WS2812FX::deserializeMapBin(const char *fileName, unsigned n) {
+  File f = WLED_FS.open(fileName, "r");
+  ledmap_bin_t hdr;
+  if (!readLedmapBinHeader(f, hdr)) {
+    if (f) f.close();
+    return false;
+  }
+  // if we are loading default ledmap (at boot) set matrix width and height from the ledmap
+  if (isMatrix && n == 0 && (hdr.width || hdr.height)) {
+    Segment::maxWidth  = min(max((int)hdr.width,  1), 128);
+    Segment::maxHeight = min(max((int)hdr.height, 1), 128);
+  }
+
+  if (customMappingTable) delete[] customMappingTable;
+  customMappingTable = new uint16_t[getLengthTotal()];
+  if (!customMappingTable) {
+    DEBUG_PRINTLN(F("ERROR LED map allocation error."));
+    f.close();
+    return false;
+  }
+
+  DEBUG_PRINT(F("Reading binary LED map from ")); DEBUG_PRINTLN(fileName);
+  const unsigned len = min((unsigned)hdr.count, (unsigned)getLengthTotal());
+  unsigned filled = 0;
+  if (hdr.encoding == LEDMAP_BIN_RAW) {
+    // stored in MCU byte order (little endian)
+    filled = f.read((uint8_t*)customMappingTable, len * sizeof(uint16_t)) / sizeof(uint16_t);
+  } else {
+    uint16_t run[3]; // first, count, step
+    while (filled < len && f.read((uint8_t*)run, sizeof(run)) == sizeof(run)) {
+      unsigned val = run[0];
+      for (unsigned k = 0; k < run[1] && filled < len; k++, val += int16_t(run[2])) customMappingTable[filled++] = val;
+    }
+  }
+  f.close();
+  if (filled < len) return false; // truncated file
+  customMappingSize = len;
+  return customMappingSize > 0;
+}
+
+// coalesce ledmap into runs of logical pixels that land on consecutive pixels of one bus
+// pixels that are mapped out are skipped; if any pixel is on overlapping buses runs are not used
+void WS2812FX::updateRoutes() {
+  _routes.clear();
+  const unsigned len = getLengthTotal();
+  bool routable = customMappingSize > 0;
+  route_t run = {0, 0, 0, 0};
+  unsigned prevPix = 0;
+  for (unsigned i = 0; routable && i < len; i++) {
+    const unsigned pix = i < customMappingSize ? customMappingTable[i] : i;
+    const unsigned b   = pix < _length ? BusManager::getBusNrForPixel(pix) : BUS_ROUTE_NONE;
+    if (b == BUS_ROUTE_NONE) continue;           // mapped out
+    if (b == BUS_ROUTE_MULTI) routable = false;  // needs per-pixel search
+    if (run.count && b == run.bus && pix == prevPix + 1 && i == unsigned(run.index + run.count)) run.count++;
+    else {
+      if (run.count) _routes.push_back(run);
+      run.index = i;
+      run.count = 1;
+      run.local = pix - BusManager::getBus(b)->getStart();
+      run.bus   = b;
+    }
+    prevPix = pix;
+  }
+  if (run.count) _routes.push_back(run);
+  // a map that does not coalesce is no faster than per-pixel routing, do not waste RAM
+  if (!routable || _routes.size() > len / 4) _routes.clear();
+  _routes.shrink_to_fit();
+  DEBUG_PRINTF_P(PSTR("Ledmap routes: %u\n"), (unsigned)_routes.size());
+}
+
 
 WS2812FX* WS2812FX::instance = nullptr;
 
@@ -27,7 +27,9 @@ extern bool cctICused;
 uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb);
 
 //udp.cpp
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+void realtimePacketLayout(uint8_t type, bool isRGBW, size_t &headerSize, size_t &pixelsPerPacket);
+void realtimeInitPackets(uint8_t type, uint8_t *packets, uint16_t length, bool isRGBW, uint16_t startOffset=0);
+uint8_t realtimeBroadcast(uint8_t type, const IPAddress *clients, size_t numClients, uint16_t length, byte *packets, uint8_t bri=255, bool isRGBW=false);
 
 // enable additional debug output
 #if defined(WLED_DEBUG_HOST)
@@ -78,13 +80,14 @@ uint8_t IRAM_ATTR ColorOrderMap::getPixelColorOrder(uint16_t pix, uint8_t defaul
 }
 
 
-void Bus::calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw) {
+// cct defaults to Bus::_cct, output task passes CCT stored with each pixel (or latched in BusManager::show()) instead
+void Bus::calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw, int16_t busCCT) {
   unsigned cct = 0; //0 - full warm white, 255 - full cold white
   unsigned w = W(c);
 
-  if (_cct > -1) {                                    // using RGB?
-    if (_cct >= 1900)    cct = (_cct - 1900) >> 5;    // convert K in relative format
-    else if (_cct < 256) cct = _cct;                  // already relative
+  if (busCCT > -1) {                                    // using RGB?
+    if (busCCT >= 1900)    cct = (busCCT - 1900) >> 5;  // convert K in relative format
+    else if (busCCT < 256) cct = busCCT;                // already relative
   } else {
     cct = (approximateKelvinFromRGB(c) - 1900) >> 5;  // convert K (from RGB value) to relative format
   }
@@ -128,6 +131,11 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 , _milliAmpsPerLed(bc.milliAmpsPerLed)
 , _milliAmpsMax(bc.milliAmpsMax)
 , _colorOrderMap(com)
+, _milliAmpsTotal(0)
+, _shownBri(0)
+, _bufferValid(false)
+, _powerSumValid(true) // buffer is allocated cleared
+, _powerSum(0)
 {
   if (!isDigital(bc.type) || !bc.count) return;
   if (!PinManager::allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
@@ -162,9 +170,28 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 //Stay safe with high amperage and have a reasonable safety margin!
 //I am NOT to be held liable for burned down garages or houses!
 
+// contribution of a single pixel to the bus channel sum
+uint32_t IRAM_ATTR BusDigital::pixelPower(uint32_t c) const {
+  byte r = R(c), g = G(c), b = B(c), w = W(c);
+  if (_milliAmpsPerLed == 255) return (max(max(r,g),b)) * 3; //ignore white component on WS2815 power calculation
+  return r + g + b + w;
+}
+
+// bulk path: sums up the usage of each LED (used if bus is not double buffered or the running sum is invalid)
+uint32_t BusDigital::recalculatePowerSum() {
+  uint32_t sum = 0;
+  for (unsigned i = 0; i < getLength(); i++) {
+    sum += pixelPower(getPixelColor(i)); // always returns original or restored color without brightness scaling
+  }
+  if (_data) {
+    _powerSum = sum;
+    _powerSumValid = true;
+  }
+  return sum;
+}
+
 // To disable brightness limiter we either set output max current to 0 or single LED current to 0
 uint8_t BusDigital::estimateCurrentAndLimitBri() {
-  bool useWackyWS2815PowerModel = false;
   byte actualMilliampsPerLed = _milliAmpsPerLed;
 
   if (_milliAmpsMax < MA_FOR_ESP/BusManager::getNumBusses() || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
@@ -172,8 +199,7 @@ uint8_t BusDigital::estimateCurrentAndLimitBri() {
   }
 
   if (_milliAmpsPerLed == 255) {
-    useWackyWS2815PowerModel = true;
-    actualMilliampsPerLed = 12; // from testing an actual strip
+    actualMilliampsPerLed = 12; // from testing an actual strip (white component is ignored in pixelPower())
   }
 
   size_t powerBudget = (_milliAmpsMax - MA_FOR_ESP/BusManager::getNumBusses()); //80/120mA for ESP power
@@ -183,17 +209,8 @@ uint8_t BusDigital::estimateCurrentAndLimitBri() {
     powerBudget = 0;
   }
 
-  uint32_t busPowerSum = 0;
-  for (unsigned i = 0; i < getLength(); i++) {  //sum up the usage of each LED
-    uint32_t c = getPixelColor(i); // always returns original or restored color without brightness scaling
-    byte r = R(c), g = G(c), b = B(c), w = W(c);
-
-    if (useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-      busPowerSum += (max(max(r,g),b)) * 3;
-    } else {
-      busPowerSum += (r + g + b + w);
-    }
-  }
+  // double buffered bus maintains channel sum in setPixelColor()
+  uint32_t busPowerSum = (_data && _powerSumValid) ? _powerSum : recalculatePowerSum();
 
   if (hasWhite()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
     busPowerSum *= 3;
@@ -216,17 +233,24 @@ uint8_t BusDigital::estimateCurrentAndLimitBri() {
 }
 
 void BusDigital::show() {
-  _milliAmpsTotal = 0;
-  if (!_valid) return;
+  if (!_valid) { _milliAmpsTotal = 0; return; }
+  // nothing changed since last show(): LEDs (and current estimate) are still valid, skip copy and transmit
+  // buses requiring refresh in off state are always sent
+  if (!_dirty && !_needsRefresh) return;
 
   uint8_t cctWW = 0, cctCW = 0;
   unsigned newBri = estimateCurrentAndLimitBri();  // will fill _milliAmpsTotal
   if (newBri < _bri) PolyBus::setBrightness(_busPtr, _iType, newBri); // limit brightness to stay within current limits
 
+  // bus buffer needs to be kept consistent (a bit slower) only if partial updates are expected
+  bool keepBuffer = !_data || (_dirtyEnd - _dirtyStart) < _len;
   if (_data) {
+    // repaint only changed pixels if bus buffer holds last frame painted with the same brightness
+    size_t first = 0, last = _len;
+    if (_bufferValid && _shownBri == newBri && _dirty) { first = _dirtyStart; last = _dirtyEnd; }
+    if (_type == TYPE_WS2812_1CH_X3) { first -= first % 3; last = min(last + 2 - (last + 2) % 3, (size_t)_len); } // whole ICs
     size_t channels = getNumberOfChannels();
-    int16_t oldCCT = Bus::_cct; // temporarily save bus CCT
-    for (size_t i=0; i<_len; i++) {
+    for (size_t i=first; i<last; i++) {
       size_t offset = i * channels;
       unsigned co = _colorOrderMap.getPixelColorOrder(i+_start, _colorOrder);
       uint32_t c;
@@ -244,8 +268,7 @@ void BusDigital::show() {
         // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
         // we need to extract and appy CCT value for each pixel individually even though all buses share the same _cct variable
         // TODO: there is an issue if CCT is calculated from RGB value (_cct==-1), we cannot do that with double buffer
-        Bus::_cct = _data[offset+channels-1];
-        Bus::calculateCCT(c, cctWW, cctCW);
+        Bus::calculateCCT(c, cctWW, cctCW, _data[offset+channels-1]); // Bus::_cct is not touched as loop() may be rendering next frame
       }
       unsigned pix = i;
       if (_reversed) pix = _len - pix -1;
@@ -256,7 +279,6 @@ void BusDigital::show() {
     if (_skip) PolyBus::setPixelColor(_busPtr, _iType, 0, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
     #endif
     for (int i=1; i<_skip; i++) PolyBus::setPixelColor(_busPtr, _iType, i, 0, _colorOrderMap.getPixelColorOrder(_start, _colorOrder)); // paint skipped pixels black
-    Bus::_cct = oldCCT;
   } else {
     if (newBri < _bri) {
       unsigned hwLen = _len;
@@ -264,16 +286,19 @@ void BusDigital::show() {
       for (unsigned i = 0; i < hwLen; i++) {
         // use 0 as color order, actual order does not matter here as we just update the channel values as-is
         uint32_t c = restoreColorLossy(PolyBus::getPixelColor(_busPtr, _iType, i, 0), _bri);
-        if (hasCCT()) Bus::calculateCCT(c, cctWW, cctCW); // this will unfortunately corrupt (segment) CCT data on every bus
+        if (hasCCT()) Bus::calculateCCT(c, cctWW, cctCW, _cctShow); // this will unfortunately corrupt (segment) CCT data on every bus
         PolyBus::setPixelColor(_busPtr, _iType, i, c, 0, (cctCW<<8) | cctWW); // repaint all pixels with new brightness
       }
     }
   }
-  PolyBus::show(_busPtr, _iType, !_data); // faster if buffer consistency is not important (use !_buffering this causes 20% FPS drop)
+  PolyBus::show(_busPtr, _iType, keepBuffer); // faster if buffer consistency is not important (use !_buffering this causes 20% FPS drop)
   // restore bus brightness to its original value
   // this is done right after show, so this is only OK if LED updates are completed before show() returns
   // or async show has a separate buffer (ESP32 RMT and I2S are ok)
   if (newBri < _bri) PolyBus::setBrightness(_busPtr, _iType, _bri);
+  _shownBri    = newBri;
+  _bufferValid = keepBuffer;
+  _dirty       = false;
 }
 
 bool BusDigital::canShow() const {
@@ -302,17 +327,24 @@ void IRAM_ATTR BusDigital::setPixelColor(unsigned pix, uint32_t c) {
   if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
   if (_data) {
     size_t offset = pix * getNumberOfChannels();
-    uint8_t* dataptr = _data + offset;
+    uint8_t chan[5];
+    unsigned n = 0;
     if (hasRGB()) {
-      *dataptr++ = R(c);
-      *dataptr++ = G(c);
-      *dataptr++ = B(c);
+      chan[n++] = R(c);
+      chan[n++] = G(c);
+      chan[n++] = B(c);
     }
-    if (hasWhite()) *dataptr++ = W(c);
+    if (hasWhite()) chan[n++] = W(c);
     // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
     // we need to store CCT value for each pixel (if there is a color correction in play, convert K in CCT ratio)
-    if (hasCCT()) *dataptr = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
+    if (hasCCT()) chan[n++] = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
+    if (memcmp(_data + offset, chan, n) == 0) return; // unchanged, keep bus clean
+    _powerSum -= pixelPower(getPixelColor(pix));
+    memcpy(_data + offset, chan, n);
+    _powerSum += pixelPower(getPixelColor(pix));
+    markDirty(pix);
   } else {
+    markDirty(pix);
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
     unsigned co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
@@ -409,6 +441,8 @@ std::vector<LEDType> BusDigital::getLEDTypes() {
 void BusDigital::begin() {
   if (!_valid) return;
   PolyBus::begin(_busPtr, _iType, _pins, _frequencykHz);
+  _bufferValid = false;
+  markDirty(); // (re)initialised bus needs to be painted again
 }
 
 void BusDigital::cleanup() {
@@ -701,7 +735,10 @@ std::vector<LEDType> BusOnOff::getLEDTypes() {
 
 BusNetwork::BusNetwork(BusConfig &bc)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count)
+, _numClients(1)
+, _startOffset(bc.frequency) // frequency field is (ab)used for start universe/channel
 , _broadcastLock(false)
+, _lastSend(0)
 {
   switch (bc.type) {
     case TYPE_NET_ARTNET_RGB:
@@ -721,8 +758,18 @@ BusNetwork::BusNetwork(BusConfig &bc)
   _hasWhite = hasWhite(bc.type);
   _hasCCT = false;
   _UDPchannels = _hasWhite + 3;
-  _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
-  _valid = (allocateData(_len * _UDPchannels) != nullptr);
+  _clients[0] = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
+  for (size_t i = 0; i < bc.numDestinations && _numClients < WLED_MAX_NET_DESTINATIONS; i++) {
+    _clients[_numClients++] = IPAddress(bc.destinations[i][0], bc.destinations[i][1], bc.destinations[i][2], bc.destinations[i][3]);
+  }
+  // pixel data is stored directly in the payload of prebuilt packets
+  size_t headerSize, pixelsPerPacket;
+  realtimePacketLayout(_UDPtype, _hasWhite, headerSize, pixelsPerPacket);
+  _headerSize      = headerSize;
+  _pixelsPerPacket = pixelsPerPacket;
+  _packetStride    = headerSize + pixelsPerPacket * _UDPchannels;
+  _valid = (allocateData(((_len + pixelsPerPacket - 1) / pixelsPerPacket) * _packetStride) != nullptr);
+  if (_valid) realtimeInitPackets(_UDPtype, _data, _len, _hasWhite, _startOffset);
   DEBUG_PRINTF_P(PSTR("%successfully inited virtual strip with type %u and IP %u.%u.%u.%u\n"), _valid?"S":"Uns", bc.type, bc.pins[0], bc.pins[1], bc.pins[2], bc.pins[3]);
 }
 
@@ -730,35 +777,51 @@ void BusNetwork::setPixelColor(unsigned pix, uint32_t c) {
   if (!_valid || pix >= _len) return;
   if (_hasWhite) c = autoWhiteCalc(c);
   if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
-  unsigned offset = pix * _UDPchannels;
+  unsigned offset = dataOffset(pix);
+  if (getPixelColor(pix) == (_hasWhite ? c : c & 0x00FFFFFF)) return; // unchanged, keep bus clean
   _data[offset]   = R(c);
   _data[offset+1] = G(c);
   _data[offset+2] = B(c);
   if (_hasWhite) _data[offset+3] = W(c);
+  markDirty(pix);
 }
 
 uint32_t BusNetwork::getPixelColor(unsigned pix) const {
   if (!_valid || pix >= _len) return 0;
-  unsigned offset = pix * _UDPchannels;
+  unsigned offset = dataOffset(pix);
   return RGBW32(_data[offset], _data[offset+1], _data[offset+2], (hasWhite() ? _data[offset+3] : 0));
 }
 
+// unchanged frames are still re-sent every NET_BUS_REFRESH_MS so receivers do not time out of realtime mode
+#ifndef NET_BUS_REFRESH_MS
+  #define NET_BUS_REFRESH_MS 1000
+#endif
+
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
+  if (!_dirty && millis() - _lastSend < NET_BUS_REFRESH_MS) return;
   _broadcastLock = true;
-  realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, hasWhite());
+  realtimeBroadcast(_UDPtype, _clients, _numClients, _len, _data, _bri, hasWhite()); // data is packed once for all receivers
   _broadcastLock = false;
+  _lastSend = millis();
+  _dirty = false;
 }
 
 uint8_t BusNetwork::getPins(uint8_t* pinArray) const {
-  if (pinArray) for (unsigned i = 0; i < 4; i++) pinArray[i] = _client[i];
+  if (pinArray) for (unsigned i = 0; i < 4; i++) pinArray[i] = _clients[0][i];
   return 4;
 }
 
+uint8_t BusNetwork::getDestinations(IPAddress *ips) const {
+  if (ips) for (unsigned i = 1; i < _numClients; i++) ips[i-1] = _clients[i];
+  return _numClients - 1;
+}
+
 // credit @willmmiles & @netmindz https://github.com/Aircoookie/WLED/pull/4056
 std::vector<LEDType> BusNetwork::getLEDTypes() {
   return {
     {TYPE_NET_DDP_RGB,     "N",     PSTR("DDP RGB (network)")},      // should be "NNNN" to determine 4 "pin" fields
+    {TYPE_NET_E131_RGB,    "N",     PSTR("E1.31 RGB (network)")},
     {TYPE_NET_ARTNET_RGB,  "N",     PSTR("Art-Net RGB (network)")},
     {TYPE_NET_DDP_RGBW,    "N",     PSTR("DDP RGBW (network)")},
     {TYPE_NET_ARTNET_RGBW, "N",     PSTR("Art-Net RGBW (network)")},
@@ -804,6 +867,7 @@ uint32_t BusManager::memUsage(unsigned maxChannels, unsigned maxCount, unsigned
 }
 
 int BusManager::add(BusConfig &bc) {
+  waitForOutput();
   if (getNumBusses() - getNumVirtualBusses() >= WLED_MAX_BUSSES) return -1;
   if (Bus::isVirtual(bc.type)) {
     busses[numBusses] = new BusNetwork(bc);
@@ -851,9 +915,10 @@ void BusManager::useParallelOutput() {
 void BusManager::removeAll() {
   DEBUG_PRINTLN(F("Removing all."));
   //prevents crashes due to deleting busses while in use.
-  while (!canAllShow()) yield();
+  while (!canAllShow()) yield(); // also waits for output task
   for (unsigned i = 0; i < numBusses; i++) delete busses[i];
   numBusses = 0;
+  updateRouting(); // drop routing table
   _parallelOutputs = 1;
   PolyBus::setParallelI2S1Output(false);
 }
@@ -894,6 +959,7 @@ void BusManager::esp32RMTInvertIdle() {
 #endif
 
 void BusManager::on() {
+  waitForOutput();
   #ifdef ESP8266
   //Fix for turning off onboard LED breaking bus
   if (PinManager::getPinOwner(LED_BUILTIN) == PinOwner::BusDigital) {
@@ -915,6 +981,7 @@ void BusManager::on() {
 }
 
 void BusManager::off() {
+  waitForOutput();
   #ifdef ESP8266
   // turn off built-in LED if strip is turned off
   // this will break digital bus so will need to be re-initialised on On
@@ -929,21 +996,100 @@ void BusManager::off() {
   #endif
 }
 
-void BusManager::show() {
-  _milliAmpsUsed = 0;
+void BusManager::showBuses() {
+  unsigned milliAmps = 0;
   for (unsigned i = 0; i < numBusses; i++) {
     busses[i]->show();
-    _milliAmpsUsed += busses[i]->getUsedCurrent();
+    milliAmps += busses[i]->getUsedCurrent();
+  }
+  _milliAmpsUsed = milliAmps;
+}
+
+#ifdef WLED_OUTPUT_TASK
+// sends buses handed over by show(); bus buffers act as front buffer while segment and strip buffers
+// (back buffer) are rendered on the other core, so frame N+1 is computed while frame N is sent
+void BusManager::outputTask(void *) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    showBuses();
+    _outputBusy = false;
+  }
+}
+#endif
+
+#ifdef WLED_OUTPUT_TASK
+void BusManager::waitForOutput() {
+  if (_outputBusy) {
+    unsigned long start = micros();
+    while (_outputBusy) delay(0);
+    _outputWaitUs += micros() - start;
   }
+  if (_pendingBri >= 0) {
+    const uint8_t b = _pendingBri;
+    _pendingBri = -1;
+    for (unsigned i = 0; i < numBusses; i++) busses[i]->setBrightness(b);
+  }
+}
+
+uint32_t BusManager::takeOutputWait() {
+  uint32_t us = _outputWaitUs;
+  _outputWaitUs = 0;
+  return us;
+}
+#endif
+
+void BusManager::show() {
+  waitForOutput(); // previous frame must be sent before buses are handed over again
+  Bus::latchCCT(); // output task must not use Bus::_cct as it changes while next frame is rendered
+  #ifdef WLED_OUTPUT_TASK
+  if (!_outputTask) {
+    // run on the core not running loop()
+    xTaskCreatePinnedToCore(outputTask, "LEDout", 3072, nullptr, WLED_OUTPUT_TASK_PRIORITY, &_outputTask, xPortGetCoreID() ? 0 : 1);
+    DEBUG_PRINTF_P(PSTR("Output task %s.\n"), _outputTask ? "started" : "failed");
+  }
+  if (_outputTask) {
+    _outputBusy = true;
+    xTaskNotifyGive(_outputTask);
+    return;
+  }
+  #endif
+  showBuses();
 }
 
 void BusManager::setStatusPixel(uint32_t c) {
+  waitForOutput();
   for (unsigned i = 0; i < numBusses; i++) {
     busses[i]->setStatusPixel(c);
   }
 }
 
+// build table of bus index for each pixel, so that pixel writes do not need to search all buses
+void BusManager::updateRouting() {
+  free(_pixelBus);
+  _pixelBus = nullptr;
+  _pixelBusLen = 0;
+  unsigned len = 0;
+  for (unsigned i = 0; i < numBusses; i++) len = max(len, unsigned(busses[i]->getStart() + busses[i]->getLength()));
+  if (len == 0) return;
+  _pixelBus = (uint8_t*)malloc(len); // if this fails buses are searched for every pixel
+  if (!_pixelBus) return;
+  memset(_pixelBus, BUS_ROUTE_NONE, len);
+  for (unsigned i = 0; i < numBusses; i++) {
+    const unsigned bstart = busses[i]->getStart();
+    const unsigned bend   = bstart + busses[i]->getLength();
+    for (unsigned p = bstart; p < bend; p++) _pixelBus[p] = (_pixelBus[p] == BUS_ROUTE_NONE) ? i : BUS_ROUTE_MULTI;
+  }
+  _pixelBusLen = len;
+  DEBUG_PRINTF_P(PSTR("Bus routing: %u pixels.\n"), len);
+}
+
 void IRAM_ATTR BusManager::setPixelColor(unsigned pix, uint32_t c) {
+  const unsigned b = getBusNrForPixel(pix);
+  if (b == BUS_ROUTE_NONE) return;
+  if (b != BUS_ROUTE_MULTI) {
+    busses[b]->setPixelColor(pix - busses[b]->getStart(), c);
+    return;
+  }
   for (unsigned i = 0; i < numBusses; i++) {
     unsigned bstart = busses[i]->getStart();
     if (pix < bstart || pix >= bstart + busses[i]->getLength()) continue;
@@ -951,13 +1097,32 @@ void IRAM_ATTR BusManager::setPixelColor(unsigned pix, uint32_t c) {
   }
 }
 
+// sets count consecutive pixels, each bus is looked up only once
+void IRAM_ATTR BusManager::setPixelColors(unsigned pix, const uint32_t *c, unsigned count) {
+  const unsigned end = pix + count;
+  for (unsigned i = 0; i < numBusses; i++) {
+    Bus *bus = busses[i];
+    const unsigned bstart = bus->getStart();
+    const unsigned bend   = bstart + bus->getLength();
+    const unsigned first  = max(pix, bstart);
+    const unsigned last   = min(end, bend);
+    for (unsigned p = first; p < last; p++) bus->setPixelColor(p - bstart, c[p - pix]);
+  }
+}
+
 void BusManager::setBrightness(uint8_t b) {
+  #ifdef WLED_OUTPUT_TASK
+  // only loop() starts output task so buses will not be handed over between the check and the assignment
+  if (_outputBusy) { _pendingBri = b; return; } // applied by waitForOutput() before buses are touched or sent again
+  _pendingBri = -1;
+  #endif
   for (unsigned i = 0; i < numBusses; i++) {
     busses[i]->setBrightness(b);
   }
 }
 
 void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
+  // no need to wait for output task, it uses CCT stored with pixels or Bus::_cctShow
   if (cct > 255) cct = 255;
   if (cct >= 0) {
     //if white balance correction allowed, save as kelvin value instead of 0-255
@@ -967,6 +1132,9 @@ void BusManager::setSegmentCCT(int16_t cct, bool allowWBCorrection) {
 }
 
 uint32_t BusManager::getPixelColor(unsigned pix) {
+  const unsigned b = getBusNrForPixel(pix);
+  if (b == BUS_ROUTE_NONE) return 0;
+  if (b != BUS_ROUTE_MULTI) return busses[b]->getPixelColor(pix - busses[b]->getStart());
   for (unsigned i = 0; i < numBusses; i++) {
     unsigned bstart = busses[i]->getStart();
     if (!busses[i]->containsPixel(pix)) continue;
@@ -976,6 +1144,9 @@ uint32_t BusManager::getPixelColor(unsigned pix) {
 }
 
 bool BusManager::canAllShow() {
+  #ifdef WLED_OUTPUT_TASK
+  if (_outputBusy) return false;
+  #endif
   for (unsigned i = 0; i < numBusses; i++) {
     if (!busses[i]->canShow()) return false;
   }
@@ -998,10 +1169,10 @@ bool PolyBus::useParallelI2S = false;
 
 // Bus static member definition
 int16_t Bus::_cct = -1;
+int16_t Bus::_cctShow = -1;
 uint8_t Bus::_cctBlend = 0;
 uint8_t Bus::_gAWM = 255;
 
-uint16_t BusDigital::_milliAmpsTotal = 0;
 
 uint8_t       BusManager::numBusses = 0;
 Bus*          BusManager::busses[WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES];
@@ -1009,3 +1180,11 @@ ColorOrderMap BusManager::colorOrderMap = {};
 uint16_t      BusManager::_milliAmpsUsed = 0;
 uint16_t      BusManager::_milliAmpsMax = ABL_MILLIAMPS_DEFAULT;
 uint8_t       BusManager::_parallelOutputs = 1;
+uint8_t      *BusManager::_pixelBus = nullptr;
+unsigned      BusManager::_pixelBusLen = 0;
+#ifdef WLED_OUTPUT_TASK
+TaskHandle_t  BusManager::_outputTask = nullptr;
+volatile bool BusManager::_outputBusy = false;
+int16_t       BusManager::_pendingBri = -1;
+uint32_t      BusManager::_outputWaitUs = 0;
+#endif
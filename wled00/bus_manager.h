@@ -23,6 +23,19 @@ uint16_t approximateKelvinFromRGB(uint32_t rgb);
 #define IC_INDEX_WS2812_2CH_3X(i)  ((i)*2/3)
 #define WS2812_2CH_3X_SPANS_2_ICS(i) ((i)&0x01)    // every other LED zone is on two different ICs
 
+// BusManager routing table entries other than bus index
+#define BUS_ROUTE_NONE  0xFF // pixel is not on any bus
+#define BUS_ROUTE_MULTI 0xFE // pixel is on more than one (overlapping) bus, all buses are searched
+
+// pipelined output: buses are sent by a task on the other core while the next frame is rendered
+// (only on dual core ESP32, enable with -D WLED_ENABLE_OUTPUT_TASK)
+#if defined(WLED_ENABLE_OUTPUT_TASK) && defined(ARDUINO_ARCH_ESP32) && !defined(CONFIG_FREERTOS_UNICORE)
+  #define WLED_OUTPUT_TASK
+  #ifndef WLED_OUTPUT_TASK_PRIORITY
+  #define WLED_OUTPUT_TASK_PRIORITY 2 // above audioreactive FFT (1) so sending is not delayed by it
+  #endif
+#endif
+
 struct BusConfig; // forward declaration
 
 // Defines an LED Strip and its color ordering.
@@ -73,6 +86,9 @@ class Bus {
     , _reversed(reversed)
     , _valid(false)
     , _needsRefresh(refresh)
+    , _dirty(true)
+    , _dirtyStart(0)
+    , _dirtyEnd(len)
     , _data(nullptr) // keep data access consistent across all types of buses
     {
       _autoWhiteMode = Bus::hasWhite(type) ? aw : RGBW_MODE_MANUAL_ONLY;
@@ -85,7 +101,7 @@ class Bus {
     virtual bool     canShow() const                          { return true; }
     virtual void     setStatusPixel(uint32_t c)                {}
     virtual void     setPixelColor(unsigned pix, uint32_t c) = 0;
-    virtual void     setBrightness(uint8_t b)                  { _bri = b; };
+    virtual void     setBrightness(uint8_t b)                  { if (_bri != b) markDirty(); _bri = b; };
     virtual void     setColorOrder(uint8_t co)                 {}
     virtual uint32_t getPixelColor(unsigned pix) const         { return 0; }
     virtual uint8_t  getPins(uint8_t* pinArray = nullptr) const { return 0; }
@@ -118,6 +134,14 @@ class Bus {
     inline  bool     isReversed() const                        { return _reversed; }
     inline  bool     isOffRefreshRequired() const              { return _needsRefresh; }
     inline  bool     containsPixel(uint16_t pix) const         { return pix >= _start && pix < _start + _len; }
+    // dirty tracking: bus needs to be shown only if any pixel (or brightness) changed since last show()
+    inline  bool     isDirty() const                           { return _dirty; }
+    inline  void     markDirty()                               { _dirty = true; _dirtyStart = 0; _dirtyEnd = _len; }
+    inline  void     markDirty(unsigned pix) {
+      if (!_dirty) { _dirty = true; _dirtyStart = pix; _dirtyEnd = pix + 1; return; }
+      if (pix <  _dirtyStart) _dirtyStart = pix;
+      if (pix >= _dirtyEnd)   _dirtyEnd   = pix + 1;
+    }
 
     static inline std::vector<LEDType> getLEDTypes()           { return {{TYPE_NONE, "", PSTR("None")}}; } // not used. just for reference for derived classes
     static constexpr uint32_t getNumberOfPins(uint8_t type)     { return isVirtual(type) ? 4 : isPWM(type) ? numPWMPins(type) : is2Pin(type) + 1; } // credit @PaoloTK
@@ -152,6 +176,7 @@ class Bus {
     static inline void     setGlobalAWMode(uint8_t m) { if (m < 5) _gAWM = m; else _gAWM = AW_GLOBAL_DISABLED; }
     static inline uint8_t  getGlobalAWMode()          { return _gAWM; }
     static inline void     setCCT(int16_t cct)        { _cct = cct; }
+    static inline void     latchCCT()                 { _cctShow = _cct; } // snapshot for show() (frame is handed over)
     static inline uint8_t  getCCTBlend()              { return _cctBlend; }
     static inline void setCCTBlend(uint8_t b) {
       _cctBlend = (std::min((int)b,100) * 127) / 100;
@@ -160,7 +185,7 @@ class Bus {
         if (_cctBlend > WLED_MAX_CCT_BLEND) _cctBlend = WLED_MAX_CCT_BLEND;
       #endif
     }
-    static void calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw);
+    static void calculateCCT(uint32_t c, uint8_t &ww, uint8_t &cw, int16_t cct = _cct);
 
   protected:
     uint8_t  _type;
@@ -174,7 +199,10 @@ class Bus {
       bool _hasRgb;//       : 1;
       bool _hasWhite;//     : 1;
       bool _hasCCT;//       : 1;
+      bool _dirty;//        : 1;
     //} __attribute__ ((packed));
+    uint16_t _dirtyStart;     // first changed pixel (valid if _dirty)
+    uint16_t _dirtyEnd;       // one past last changed pixel (valid if _dirty)
     uint8_t  _autoWhiteMode;
     uint8_t  *_data;
     // global Auto White Calculation override
@@ -184,6 +212,7 @@ class Bus {
     //    [0,255] is the exact CCT value where 0 means warm and 255 cold
     //    [1900,10060] only for color correction expressed in K (colorBalanceFromKelvin())
     static int16_t _cct;
+    static int16_t _cctShow; // _cct latched by BusManager::show() for use while sending
     // _cctBlend determines WW/CW blending:
     //    0 - linear (CCT 127 => 50% warm, 50% cold)
     //   63 - semi additive/nonlinear (CCT 127 => 66% warm, 66% cold)
@@ -230,8 +259,11 @@ class BusDigital : public Bus {
     uint16_t _milliAmpsMax;
     void * _busPtr;
     const ColorOrderMap &_colorOrderMap;
-
-    static uint16_t _milliAmpsTotal; // is overwitten/recalculated on each show()
+    uint16_t _milliAmpsTotal; // is recalculated on each show() (and kept if bus is not dirty)
+    uint8_t  _shownBri;       // brightness bus buffer was painted with in last show()
+    bool     _bufferValid;    // bus buffer still holds last frame (only dirty range needs repainting)
+    bool     _powerSumValid;  // _powerSum matches buffer content (only maintained if bus is double buffered)
+    uint32_t _powerSum;       // running sum of channel values used for current estimation (see pixelPower())
 
     inline uint32_t restoreColorLossy(uint32_t c, uint8_t restoreBri) const {
       if (restoreBri < 255) {
@@ -244,6 +276,8 @@ class BusDigital : public Bus {
       return c;
     }
 
+    [[gnu::hot]] uint32_t pixelPower(uint32_t c) const;
+    uint32_t recalculatePowerSum();
     uint8_t  estimateCurrentAndLimitBri();
 };
 
@@ -303,16 +337,30 @@ class BusNetwork : public Bus {
     void setPixelColor(unsigned pix, uint32_t c) override;
     uint32_t getPixelColor(unsigned pix) const override;
     uint8_t  getPins(uint8_t* pinArray = nullptr) const override;
+    uint16_t getFrequency() const override { return _startOffset; } // start universe/channel is stored in frequency field
     void show() override;
     void cleanup();
 
+    uint8_t  getDestinations(IPAddress *ips = nullptr) const; // additional receivers (excluding the one set by pins)
+
     static std::vector<LEDType> getLEDTypes();
 
   private:
-    IPAddress _client;
+    IPAddress _clients[WLED_MAX_NET_DESTINATIONS]; // first one is set by pins, others are additional receivers
+    uint8_t   _numClients;
+    uint16_t  _startOffset;     // first universe (E1.31, Art-Net) or channel (DDP)
     uint8_t   _UDPtype;
     uint8_t   _UDPchannels;
     bool      _broadcastLock;
+    unsigned long _lastSend;  // millis() of last sent frame (unchanged frames are re-sent periodically)
+    uint16_t  _headerSize;       // size of protocol header preceding each packet payload
+    uint16_t  _pixelsPerPacket;  // pixels in a full packet (pixels are never split across packets)
+    uint16_t  _packetStride;     // distance between packets in _data
+
+    // offset of pixel data in _data (packet buffer)
+    inline unsigned dataOffset(unsigned pix) const {
+      return (pix / _pixelsPerPacket) * _packetStride + _headerSize + (pix % _pixelsPerPacket) * _UDPchannels;
+    }
 };
 
 
@@ -331,6 +379,8 @@ struct BusConfig {
   bool doubleBuffer;
   uint8_t milliAmpsPerLed;
   uint16_t milliAmpsMax;
+  uint8_t numDestinations = 0;                           // network buses: additional receivers
+  uint8_t destinations[WLED_MAX_NET_DESTINATIONS-1][4];
 
   BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0, byte aw=RGBW_MODE_MANUAL_ONLY, uint16_t clock_kHz=0U, bool dblBfr=false, uint8_t maPerLed=LED_MILLIAMPS_DEFAULT, uint16_t maMax=ABL_MILLIAMPS_DEFAULT)
   : count(len)
@@ -350,6 +400,14 @@ struct BusConfig {
     for (size_t i = 0; i < nPins; i++) pins[i] = ppins[i];
   }
 
+  //adds receiver IP address for network bus (same data is sent to all receivers)
+  bool addDestination(const IPAddress &ip) {
+    if (numDestinations >= WLED_MAX_NET_DESTINATIONS-1 || !ip[0]) return false;
+    for (size_t i = 0; i < 4; i++) destinations[numDestinations][i] = ip[i];
+    numDestinations++;
+    return true;
+  }
+
   //validates start and length and extends total if needed
   bool adjustBounds(uint16_t& total) {
     if (!count) count = 1;
@@ -393,10 +451,19 @@ class BusManager {
     static void on();
     static void off();
 
-    static void show();
-    static bool canAllShow();
+    static void show();        // with output task: hands buses over to the task and returns immediately
+    static bool canAllShow();  // false while output task is sending
+    #ifdef WLED_OUTPUT_TASK
+    static void waitForOutput();      // bus buffers must not be written while output task is sending, call once per frame before
+                                      // writing pixels (pixel functions do not check it); applies deferred brightness
+    static uint32_t takeOutputWait(); // microseconds spent in waitForOutput() since last call
+    #else
+    static inline void waitForOutput() {}
+    static inline uint32_t takeOutputWait() { return 0; }
+    #endif
     static void setStatusPixel(uint32_t c);
     [[gnu::hot]] static void setPixelColor(unsigned pix, uint32_t c);
+    [[gnu::hot]] static void setPixelColors(unsigned pix, const uint32_t *c, unsigned count);
     static void setBrightness(uint8_t b);
     // for setSegmentCCT(), cct can only be in [-1,255] range; allowWBCorrection will convert it to K
     // WARNING: setSegmentCCT() is a misleading name!!! much better would be setGlobalCCT() or just setCCT()
@@ -405,7 +472,9 @@ class BusManager {
     [[gnu::hot]] static uint32_t getPixelColor(unsigned pix);
     static inline int16_t getSegmentCCT() { return Bus::getCCT(); }
 
-    static Bus* getBus(uint8_t busNr);
+    static Bus* getBus(uint8_t busNr); // call waitForOutput() before accessing pixels of returned bus
+    static inline uint8_t getBusNrForPixel(unsigned pix) { return pix < _pixelBusLen ? _pixelBus[pix] : BUS_ROUTE_MULTI; } // BUS_ROUTE_MULTI if unknown
+    static void updateRouting(); // rebuild pixel to bus table, call after all buses have been added
 
     //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
     static uint16_t getTotalLength();
@@ -421,6 +490,16 @@ class BusManager {
     static uint16_t _milliAmpsUsed;
     static uint16_t _milliAmpsMax;
     static uint8_t _parallelOutputs;
+    static uint8_t *_pixelBus;      // bus index for each pixel (avoids searching all buses on every pixel write)
+    static unsigned _pixelBusLen;   // 0 if routing table is not built
+    #ifdef WLED_OUTPUT_TASK
+    static TaskHandle_t _outputTask;
+    static volatile bool _outputBusy; // set by show(), cleared by output task when all buses are sent
+    static int16_t _pendingBri;       // brightness set while output task was sending (-1 if none)
+    static uint32_t _outputWaitUs;
+    static void outputTask(void *);
+    #endif
+    static void showBuses();
 
     #ifdef ESP32_DATA_IDLE_HIGH
     static void    esp32RMTInvertIdle() ;
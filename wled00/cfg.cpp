@@ -118,6 +118,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
   CJSON(useGlobalLedBuffer, hw_led[F("ld")]);
+  CJSON(useSegmentBuffers, hw_led[F("sb")]);
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -220,8 +221,10 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
         maMax = 0;
       }
       ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
+      JsonArray destArr = elm[F("dest")]; // additional receivers for network buses
       if (fromFS) {
         BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maPerLed, maMax);
+        for (const char *dest : destArr) { IPAddress ip; if (dest && ip.fromString(dest)) bc.addDestination(ip); }
         if (useParallel && s < 8) {
           // if for some unexplained reason the above pre-calculation was wrong, update
           unsigned memT = BusManager::memUsage(bc); // includes x8 memory allocation for parallel I2S
@@ -232,6 +235,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
       } else {
         if (busConfigs[s] != nullptr) delete busConfigs[s];
         busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maPerLed, maMax);
+        for (const char *dest : destArr) { IPAddress ip; if (dest && ip.fromString(dest)) busConfigs[s]->addDestination(ip); }
         doInitBusses = true;  // finalization done in beginStrip()
       }
       s++;
@@ -446,6 +450,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   JsonObject light_tr = light["tr"];
   CJSON(fadeTransition, light_tr["mode"]);
   CJSON(modeBlending, light_tr["fx"]);
+  CJSON(blendingStyle, light_tr[F("bs")]);
+  if (blendingStyle >= BLEND_STYLE_COUNT) blendingStyle = BLEND_STYLE_FADE;
   int tdd = light_tr["dur"] | -1;
   if (tdd >= 0) transitionDelay = transitionDelayDefault = tdd * 100;
   strip.setTransition(fadeTransition ? transitionDelayDefault : 0);
@@ -823,6 +829,7 @@ void serializeConfig() {
   hw_led["fps"] = strip.getTargetFps();
   hw_led[F("rgbwm")] = Bus::getGlobalAWMode(); // global auto white mode override
   hw_led[F("ld")] = useGlobalLedBuffer;
+  hw_led[F("sb")] = useSegmentBuffers;
 
   #ifndef WLED_DISABLE_2D
   // 2D Matrix Settings
@@ -865,6 +872,14 @@ void serializeConfig() {
     ins[F("freq")] = bus->getFrequency();
     ins[F("maxpwr")] = bus->getMaxCurrent();
     ins[F("ledma")] = bus->getLEDCurrent();
+    if (bus->isVirtual()) {
+      IPAddress dests[WLED_MAX_NET_DESTINATIONS];
+      unsigned numDests = static_cast<BusNetwork*>(bus)->getDestinations(dests);
+      if (numDests) {
+        JsonArray ins_dest = ins.createNestedArray(F("dest"));
+        for (unsigned i = 0; i < numDests; i++) ins_dest.add(dests[i].toString());
+      }
+    }
   }
 
   JsonArray hw_com = hw.createNestedArray(F("com"));
@@ -939,6 +954,7 @@ void serializeConfig() {
   JsonObject light_tr = light.createNestedObject("tr");
   light_tr["mode"] = fadeTransition;
   light_tr["fx"] = modeBlending;
+  light_tr[F("bs")] = blendingStyle;
   light_tr["dur"] = transitionDelayDefault / 100;
   light_tr["pal"] = strip.paletteFade;
   light_tr[F("rpc")] = randomPaletteChangeTime;
@@ -83,6 +83,51 @@ uint32_t color_fade(uint32_t c1, uint8_t amount, bool video)
   return scaledcolor;
 }
 
+/*
+ * layer blend modes (see blendmode_t), c1 is the bottom layer, c2 the top layer
+ * red & blue and white & green channels are processed in pairs (two 8 bit values in 16 bit lanes)
+ */
+static inline uint32_t pairMask(uint32_t a, uint32_t b) {
+  // 0xFF in each lane where a >= b (borrow from bit 8 of each lane cannot propagate to the next lane)
+  return ((((a | 0x01000100) - b) >> 8) & 0x00010001) * 0xFF;
+}
+
+static inline uint32_t color_lighten(uint32_t c1, uint32_t c2) {
+  uint32_t rb1 = c1 & 0x00FF00FF, rb2 = c2 & 0x00FF00FF;
+  uint32_t wg1 = (c1>>8) & 0x00FF00FF, wg2 = (c2>>8) & 0x00FF00FF;
+  uint32_t mrb = pairMask(rb1, rb2);
+  uint32_t mwg = pairMask(wg1, wg2);
+  return ((rb1 & mrb) | (rb2 & ~mrb & 0x00FF00FF)) | (((wg1 & mwg) | (wg2 & ~mwg & 0x00FF00FF)) << 8);
+}
+
+static inline uint32_t color_darken(uint32_t c1, uint32_t c2) {
+  uint32_t rb1 = c1 & 0x00FF00FF, rb2 = c2 & 0x00FF00FF;
+  uint32_t wg1 = (c1>>8) & 0x00FF00FF, wg2 = (c2>>8) & 0x00FF00FF;
+  uint32_t mrb = pairMask(rb1, rb2);
+  uint32_t mwg = pairMask(wg1, wg2);
+  return ((rb2 & mrb) | (rb1 & ~mrb & 0x00FF00FF)) | (((wg2 & mwg) | (wg1 & ~mwg & 0x00FF00FF)) << 8);
+}
+
+static inline uint32_t color_multiply(uint32_t c1, uint32_t c2) {
+  // x*(y+1)>>8 keeps x if y==255 and yields 0 if y==0
+  uint32_t rb = ((((c1 >> 16) & 0xFF) * (((c2 >> 16) & 0xFF) + 1)) << 8) & 0x00FF0000;
+  rb |= (((c1 & 0xFF) * ((c2 & 0xFF) + 1)) >> 8);
+  uint32_t wg = (((c1 >> 24) * ((c2 >> 24) + 1)) << 16) & 0xFF000000;
+  wg |= ((((c1 >> 8) & 0xFF) * (((c2 >> 8) & 0xFF) + 1))) & 0x0000FF00;
+  return rb | wg;
+}
+
+uint32_t color_blend_mode(uint32_t c1, uint32_t c2, uint8_t mode) {
+  switch (mode) {
+    case BLEND_MODE_ADD:      return color_add(c1, c2);
+    case BLEND_MODE_MULTIPLY: return color_multiply(c1, c2);
+    case BLEND_MODE_SCREEN:   return ~color_multiply(~c1, ~c2); // 1-(1-a)(1-b)
+    case BLEND_MODE_LIGHTEN:  return color_lighten(c1, c2);
+    case BLEND_MODE_DARKEN:   return color_darken(c1, c2);
+    default:                  return c2; // normal
+  }
+}
+
 // 1:1 replacement of fastled function optimized for ESP, slightly faster, more accurate and uses less flash (~ -200bytes)
 uint32_t ColorFromPaletteWLED(const CRGBPalette16& pal, unsigned index, uint8_t brightness, TBlendType blendType)
 {
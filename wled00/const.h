@@ -115,6 +115,15 @@
   #endif
 #endif
 
+// number of receivers a single network bus can send the same data to
+#ifndef WLED_MAX_NET_DESTINATIONS
+  #ifdef ESP8266
+    #define WLED_MAX_NET_DESTINATIONS 2
+  #else
+    #define WLED_MAX_NET_DESTINATIONS 4
+  #endif
+#endif
+
 #ifdef ESP8266
 #define WLED_MAX_COLOR_ORDER_MAPPINGS 5
 #else
@@ -132,6 +141,24 @@
   #endif
 #endif
 
+// binary ledmap file (ledmapN.bin, created by tools/ledmap_bin.py), all values are little endian
+// header (optionally followed by nameLen bytes of ledmap name) is followed by map data:
+// LEDMAP_BIN_RAW:  uint16 physical index for each logical pixel (0xFFFF = no LED)
+// LEDMAP_BIN_RUNS: records of {uint16 first, uint16 count, int16 step} expanding to first, first+step, ...
+#define LEDMAP_BIN_MAGIC   "WLMP"
+#define LEDMAP_BIN_VERSION 1
+#define LEDMAP_BIN_RAW     0
+#define LEDMAP_BIN_RUNS    1
+typedef struct __attribute__((packed)) {
+  char     magic[4];
+  uint8_t  version;
+  uint8_t  encoding;
+  uint16_t count;    // number of logical pixels in map
+  uint16_t width;    // matrix dimensions (0 if not specified)
+  uint16_t height;
+  uint8_t  nameLen;  // 0-32
+} ledmap_bin_t;
+
 #ifndef WLED_MAX_SEGNAME_LEN
   #ifdef ESP8266
     #define WLED_MAX_SEGNAME_LEN 32
@@ -323,7 +350,7 @@
 //Network types (master broadcast) (80-95)
 #define TYPE_VIRTUAL_MIN         80
 #define TYPE_NET_DDP_RGB         80            //network DDP RGB bus (master broadcast bus)
-#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus, unused)
+#define TYPE_NET_E131_RGB        81            //network E131 RGB bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGB      82            //network ArtNet RGB bus (master broadcast bus, unused)
 #define TYPE_NET_DDP_RGBW        88            //network DDP RGBW bus (master broadcast bus)
 #define TYPE_NET_ARTNET_RGBW     89            //network ArtNet RGB bus (master broadcast bus, unused)
@@ -558,6 +585,17 @@
   #endif
 #endif
 
+// JSON document pool (see requestJSONDoc()), pDoc is the general purpose document
+#define JSON_DOC_GENERAL 0     // state changes, config, presets, files (requestJSONBufferLock())
+#define JSON_DOC_SERVE   1     // serializing responses (/json, WebSocket), state is only read
+#ifdef ESP8266
+  #undef JSON_DOC_SERVE_SLOTS
+  #define JSON_DOC_SERVE_SLOTS 0   // not enough RAM, responses use pDoc
+#elif !defined(JSON_DOC_SERVE_SLOTS)
+  #define JSON_DOC_SERVE_SLOTS 2   // allocated at boot with PSRAM, on demand (sized for response) otherwise
+#endif
+#define JSON_DOC_SERVE_SMALL 8192  // serve document size for small responses (perf, nodes, networks, WebSocket parts)
+
 //#define MIN_HEAP_SIZE (8k for AsyncWebServer)
 #define MIN_HEAP_SIZE 8192
 
@@ -25,7 +25,7 @@ var pN = "", pI = 0, pNum = 0;
 var pmt = 1, pmtLS = 0, pmtLast = 0;
 var lastinfo = {};
 var isM = false, mw = 0, mh=0;
-var ws, wsRpt=0;
+var ws, wsRpt=0, wsState=null; // wsState: last complete state received over WebSocket (base for delta updates)
 var cfg = {
 	theme:{base:"dark", bg:{url:"", rnd: false, rndGrayscale: false, rndBlur: false}, alpha:{bg:0.6,tab:0.8}, color:{bg:""}},
 	comp :{colors:{picker: true, rgb: false, quick: true, hex: false},
@@ -807,6 +807,16 @@ function populateSegments(s)
 							`<option value="1" ${inst.si==1?' selected':''}>WeWillRockYou</option>`+
 						`</select></div>`+
 					`</div>`;
+		let blendMode = `<div class="lbl-s">Blend mode<br>`+
+						`<div class="sel-p"><select class="sel-p" id="seg${i}bm" onchange="setBm(${i})">`+
+							`<option value="0" ${inst.bm==0?' selected':''}>Normal</option>`+
+							`<option value="1" ${inst.bm==1?' selected':''}>Add</option>`+
+							`<option value="2" ${inst.bm==2?' selected':''}>Multiply</option>`+
+							`<option value="3" ${inst.bm==3?' selected':''}>Screen</option>`+
+							`<option value="4" ${inst.bm==4?' selected':''}>Lighten</option>`+
+							`<option value="5" ${inst.bm==5?' selected':''}>Darken</option>`+
+						`</select></div>`+
+					`</div>`;
 		cn += `<div class="seg lstI ${i==s.mainseg && !simplifiedUI ? 'selected' : ''} ${exp ? "expanded":""}" id="seg${i}" data-set="${inst.set}">`+
 				`<label class="check schkl ${smpl}">`+
 					`<input type="checkbox" id="seg${i}sel" onchange="selSeg(${i})" ${inst.sel ? "checked":""}>`+
@@ -857,6 +867,7 @@ function populateSegments(s)
 					(!isMSeg ? rvXck : '') +
 					(isMSeg&&stoY-staY>1&&stoX-staX>1 ? map2D : '') +
 					(s.AudioReactive && s.AudioReactive.on ? "" : sndSim) +
+					blendMode +
 					`<label class="check revchkl" id="seg${i}lbtm">`+
 						(isMSeg?'Transpose':'Mirror effect') + (isMSeg ?
 						'<input type="checkbox" id="seg'+i+'tp" onchange="setTp('+i+')" '+(inst.tp?"checked":"")+'>':
@@ -1405,6 +1416,12 @@ function makeWS() {
 		} else
 			i = lastinfo;
 		var s = json.state ? json.state : json;
+		if (json.delta) {
+			if (!wsState) return; // wait for full state
+			if (json.state) mergeState(wsState, json.state);
+			s = wsState;
+		} else
+			wsState = s;
 		displayRover(i, s);
 		readState(s);
 	};
@@ -1415,11 +1432,29 @@ function makeWS() {
 	}
 	ws.onopen = (e)=>{
 		//ws.send("{'v':true}"); // unnecessary (https://github.com/Aircoookie/WLED/blob/master/wled00/ws.cpp#L18)
+		ws.send('{"dlt":true}'); // only receive changes after initial state
 		wsRpt = 0;
 		reqsLegal = true;
 	}
 }
 
+// apply delta update d (whole state without segments if it changed, changed segments) to state s
+function mergeState(s, d)
+{
+	if (Object.keys(d).some((k)=>k!="seg")) {
+		for (let k in s) if (k!="seg") delete s[k];
+		for (let k in d) if (k!="seg") s[k] = d[k];
+	}
+	if (!d.seg) return;
+	for (let seg of d.seg) {
+		let i = s.seg.findIndex((e)=>e.id==seg.id);
+		if (seg.stop === 0) { if (i >= 0) s.seg.splice(i,1); } // removed segment
+		else if (i >= 0) s.seg[i] = seg;
+		else s.seg.push(seg);
+	}
+	s.seg.sort((a,b)=>a.id-b.id);
+}
+
 function readState(s,command=false)
 {
 	if (!s) return false;
@@ -2291,6 +2326,13 @@ function setM12(s)
 	requestJson(obj);
 }
 
+function setBm(s)
+{
+	var value = gId(`seg${s}bm`).selectedIndex;
+	var obj = {"seg": {"id": s, "bm": value}};
+	requestJson(obj);
+}
+
 function setSi(s)
 {
 	var value = gId(`seg${s}si`).selectedIndex;
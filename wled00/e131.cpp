@@ -4,6 +4,59 @@
 #define MAX_4_CH_LEDS_PER_UNIVERSE 128
 #define MAX_CHANNELS_PER_UNIVERSE 512
 
+#define REALTIME_FRAME_TIMEOUT_MS 250  // incomplete frames are shown after this time
+#define ARTNET_SYNC_TIMEOUT_MS    4000 // Art-Net receivers stay in synchronous mode for 4s after the last ArtSync
+
+/*
+ * Realtime frame assembler
+ * Pixel data is written into the bus buffers as packets arrive but is only shown (once) when the frame is
+ * complete: E1.31 sync packet (or ArtSync), DDP push flag or all expected universes received.
+ * If a universe repeats before the frame is complete or the frame times out, it is shown as a partial frame.
+ */
+static struct {
+  uint32_t received;      // bitmask of universes (relative to e131Universe) received for the current frame
+  unsigned long started;  // millis() when the first packet of the current frame arrived
+  unsigned long artSync;  // millis() of the last ArtSync packet
+  uint16_t syncUniverse;  // E1.31 synchronization address of the current frame (0 = unsynchronized)
+  bool pending;           // a frame is being assembled
+} rtFrame = {0, 0, 0, 0, false};
+
+// finish the current frame, it is shown by handleNotifications()
+static void realtimeFrameDone(bool complete) {
+  if (!rtFrame.pending) return;
+  if (!complete) realtimeFramesPartial++;
+  rtFrame.received = 0;
+  rtFrame.pending  = false;
+  e131NewData = true;
+}
+
+// must be called before pixel data of a universe is written
+static void realtimeFrameBegin(unsigned universe) {
+  if (rtFrame.received & (1UL << universe)) realtimeFrameDone(false); // sender has moved on to the next frame
+  if (!rtFrame.pending) {
+    rtFrame.pending = true;
+    rtFrame.started = millis();
+  }
+}
+
+// must be called after pixel data of a universe has been written
+// expected is the bitmask of universes making up a full frame, synchronized frames wait for the sync packet
+static void realtimeFrameEnd(unsigned universe, uint32_t expected, bool synchronized) {
+  rtFrame.received |= 1UL << universe;
+  if (!synchronized && (rtFrame.received & expected) == expected) realtimeFrameDone(true);
+}
+
+// shows frames that were not completed in time, called from handleNotifications()
+void handleRealtimeFrame() {
+  if (!rtFrame.pending) return;
+  if (!realtimeMode) {
+    rtFrame.received = 0;
+    rtFrame.pending  = false;
+  } else if (millis() - rtFrame.started > REALTIME_FRAME_TIMEOUT_MS) {
+    realtimeFrameDone(false);
+  }
+}
+
 /*
  * E1.31 handler
  */
@@ -14,15 +67,15 @@ void handleDDPPacket(e131_packet_t* p) {
   static bool ddpSeenPush = false;  // have we seen a push yet?
   int lastPushSeq = e131LastSequenceNumber[0];
 
-  //reject late packets belonging to previous frame (assuming 4 packets max. before push)
-  if (e131SkipOutOfSequence && lastPushSeq) {
-    int sn = p->sequenceNum & 0xF;
-    if (sn) {
-      if (lastPushSeq > 5) {
-        if (sn > (lastPushSeq -5) && sn < lastPushSeq) return;
-      } else {
-        if (sn > (10 + lastPushSeq) || sn < lastPushSeq) return;
-      }
+  //detect (and reject) late packets belonging to previous frame (assuming 4 packets max. before push)
+  int sn = p->sequenceNum & 0xF;
+  if (lastPushSeq && sn) {
+    bool late;
+    if (lastPushSeq > 5) late = sn > (lastPushSeq -5) && sn < lastPushSeq;
+    else                 late = sn > (10 + lastPushSeq) || sn < lastPushSeq;
+    if (late) {
+      realtimePacketsLate++;
+      if (e131SkipOutOfSequence) return;
     }
   }
 
@@ -38,18 +91,18 @@ void handleDDPPacket(e131_packet_t* p) {
   if (realtimeMode != REALTIME_MODE_DDP) ddpSeenPush = false; // just starting, no push yet
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
+  realtimeFrameBegin(0); // DDP fragments are not tracked individually, the push flag completes the frame
   if (!realtimeOverride || (realtimeMode && useMainSegmentOnly)) {
+    SegmentBufferLock lock; // main segment buffer must not be reallocated while writing
     if (useMainSegmentOnly) strip.getMainSegment().beginDraw();
-    for (unsigned i = start; i < stop; i++, c += ddpChannelsPerLed) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], ddpChannelsPerLed >3 ? data[c+3] : 0);
-    }
+    else                    BusManager::waitForOutput(); // data is written to bus buffers directly
+    if (stop > start) setRealtimePixels(start, stop - start, &data[c], ddpChannelsPerLed);
   }
 
   bool push = p->flags & DDP_PUSH_FLAG;
   ddpSeenPush |= push;
   if (!ddpSeenPush || push) { // if we've never seen a push, or this is one, render display
-    e131NewData = true;
-    int sn = p->sequenceNum & 0xF;
+    realtimeFrameDone(true);
     if (sn) e131LastSequenceNumber[0] = sn;
   }
 }
@@ -60,6 +113,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   int uni = 0, dmxChannels = 0;
   uint8_t* e131_data = nullptr;
   int seq = 0, mde = REALTIME_MODE_E131;
+  bool synchronized = false; // frame is shown when the sync packet arrives
 
   if (protocol == P_ARTNET)
   {
@@ -67,6 +121,12 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       handleArtnetPollReply(clientIP);
       return;
     }
+    if (p->art_opcode == ARTNET_OPCODE_OPSYNC) {
+      rtFrame.artSync = millis();
+      realtimeFrameDone(true);
+      return;
+    }
+    synchronized = rtFrame.artSync && millis() - rtFrame.artSync < ARTNET_SYNC_TIMEOUT_MS;
     uni = p->art_universe;
     dmxChannels = htons(p->art_length);
     e131_data = p->art_data;
@@ -81,12 +141,18 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     uni = htons(p->universe);
     e131_data = p->property_values;
     seq = p->sequence_number;
+    rtFrame.syncUniverse = htons(p->sync_address);
+    synchronized = rtFrame.syncUniverse != 0;
     if (e131Priority != 0) {
       if (p->priority < e131Priority ) return;
       // track highest priority & skip all lower priorities
       if (p->priority >= highPriority.get()) highPriority.set(p->priority);
       if (p->priority < highPriority.get()) return;
     }
+  } else if (protocol == P_E131_SYNC) {
+    uint16_t syncUniverse = (p->raw[E131_SYNC_ADDR] << 8) | p->raw[E131_SYNC_ADDR+1];
+    if (syncUniverse == rtFrame.syncUniverse) realtimeFrameDone(true);
+    return;
   } else { //DDP
     realtimeIP = clientIP;
     handleDDPPacket(p);
@@ -107,16 +173,19 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   unsigned previousUniverses = uni - e131Universe;
 
-  if (e131SkipOutOfSequence)
-    if (seq < e131LastSequenceNumber[previousUniverses] && seq > 20 && e131LastSequenceNumber[previousUniverses] < 250){
+  if (seq < e131LastSequenceNumber[previousUniverses] && seq > 20 && e131LastSequenceNumber[previousUniverses] < 250) {
+    realtimePacketsLate++;
+    if (e131SkipOutOfSequence) {
       DEBUG_PRINTF_P(PSTR("skipping E1.31 frame (last seq=%d, current seq=%d, universe=%d)\n"), e131LastSequenceNumber[previousUniverses], seq, uni);
       return;
     }
+  }
   e131LastSequenceNumber[previousUniverses] = seq;
 
   // update status info
   realtimeIP = clientIP;
   byte wChannel = 0;
+  uint32_t expected = 1; // universes making up a full frame
   unsigned totalLen = strip.getLengthTotal();
   unsigned availDMXLen = 0;
   unsigned dataOffset = DMXAddress;
@@ -148,9 +217,14 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
       wChannel = (availDMXLen > 3) ? e131_data[dataOffset+3] : 0;
-      if (useMainSegmentOnly) strip.getMainSegment().beginDraw();
-      for (unsigned i = 0; i < totalLen; i++)
-        setRealtimePixel(i, e131_data[dataOffset+0], e131_data[dataOffset+1], e131_data[dataOffset+2], wChannel);
+      realtimeFrameBegin(0);
+      {
+        SegmentBufferLock lock; // main segment buffer must not be reallocated while writing
+        if (useMainSegmentOnly) strip.getMainSegment().beginDraw();
+        else                    BusManager::waitForOutput(); // data is written to bus buffers directly
+        for (unsigned i = 0; i < totalLen; i++)
+          setRealtimePixel(i, e131_data[dataOffset+0], e131_data[dataOffset+1], e131_data[dataOffset+2], wChannel);
+      }
       break;
 
     case DMX_MODE_SINGLE_DRGB:  // 4 channel: [Dimmer,R,G,B]
@@ -166,9 +240,14 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
         strip.setBrightness(bri, true);
       }
 
-      if (useMainSegmentOnly) strip.getMainSegment().beginDraw();
-      for (unsigned i = 0; i < totalLen; i++)
-        setRealtimePixel(i, e131_data[dataOffset+1], e131_data[dataOffset+2], e131_data[dataOffset+3], wChannel);
+      realtimeFrameBegin(0);
+      {
+        SegmentBufferLock lock; // main segment buffer must not be reallocated while writing
+        if (useMainSegmentOnly) strip.getMainSegment().beginDraw();
+        else                    BusManager::waitForOutput(); // data is written to bus buffers directly
+        for (unsigned i = 0; i < totalLen; i++)
+          setRealtimePixel(i, e131_data[dataOffset+1], e131_data[dataOffset+2], e131_data[dataOffset+3], wChannel);
+      }
       break;
 
     case DMX_MODE_PRESET:       // 2 channel: [Dimmer,Preset]
@@ -269,6 +348,8 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
         bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
         const unsigned dmxChannelsPerLed = is4Chan ? 4 : 3;
         const unsigned ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+        const unsigned dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
+        const unsigned ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
         uint8_t stripBrightness = bri;
         unsigned previousLeds, dmxOffset, ledsTotal;
 
@@ -286,8 +367,6 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
         } else {
           // All subsequent universes start at the first channel.
           dmxOffset = (protocol == P_ARTNET) ? 0 : 1;
-          const unsigned dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
-          unsigned ledsInFirstUniverse = (((MAX_CHANNELS_PER_UNIVERSE - DMXAddress) + dmxLenOffset) - dimmerOffset) / dmxChannelsPerLed;
           previousLeds = ledsInFirstUniverse + (previousUniverses - 1) * ledsPerUniverse;
           ledsTotal = previousLeds + (dmxChannels / dmxChannelsPerLed);
         }
@@ -304,6 +383,12 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           ledsTotal = totalLen;
         }
 
+        // number of universes needed to cover all LEDs
+        unsigned universes = 1;
+        if (totalLen > ledsInFirstUniverse) universes += (totalLen - ledsInFirstUniverse + ledsPerUniverse - 1) / ledsPerUniverse;
+        if (universes > E131_MAX_UNIVERSE_COUNT) universes = E131_MAX_UNIVERSE_COUNT;
+        expected = (1UL << universes) - 1;
+
         if (DMXMode == DMX_MODE_MULTIPLE_DRGB && previousUniverses == 0) {
           if (bri != stripBrightness) {
             bri = stripBrightness;
@@ -311,18 +396,11 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
           }
         }
 
+        realtimeFrameBegin(previousUniverses);
+        SegmentBufferLock lock; // main segment buffer must not be reallocated while writing
         if (useMainSegmentOnly) strip.getMainSegment().beginDraw();
-        if (!is4Chan) {
-          for (unsigned i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (unsigned i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
-          }
-        }
+        else                    BusManager::waitForOutput(); // data is written to bus buffers directly
+        if (ledsTotal > previousLeds) setRealtimePixels(previousLeds, ledsTotal - previousLeds, &e131_data[dmxOffset], dmxChannelsPerLed);
         break;
       }
     default:
@@ -331,7 +409,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       break;
   }
 
-  e131NewData = true;
+  realtimeFrameEnd(previousUniverses, expected, synchronized);
 }
 
 void handleArtnetPollReply(IPAddress ipAddress) {
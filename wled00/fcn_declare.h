@@ -165,6 +165,7 @@ class NeoGammaWLEDMethod {
 inline uint32_t color_blend16(uint32_t c1, uint32_t c2, uint16_t b) { return color_blend(c1, c2, b >> 8); };
 [[gnu::hot]] uint32_t color_add(uint32_t, uint32_t, bool preserveCR = false);
 [[gnu::hot]] uint32_t color_fade(uint32_t c1, uint8_t amount, bool video=false);
+[[gnu::hot]] uint32_t color_blend_mode(uint32_t c1, uint32_t c2, uint8_t mode);
 [[gnu::hot]] uint32_t ColorFromPaletteWLED(const CRGBPalette16 &pal, unsigned index, uint8_t brightness = (uint8_t)255U, TBlendType blendType = LINEARBLEND);
 CRGBPalette16 generateHarmonicRandomPalette(CRGBPalette16 &basepalette);
 CRGBPalette16 generateRandomPalette();
@@ -189,6 +190,7 @@ void handleDMX();
 
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+void handleRealtimeFrame();
 void handleArtnetPollReply(IPAddress ipAddress);
 void prepareArtnetPollReply(ArtPollReply* reply);
 void sendArtnetPollReply(ArtPollReply* reply, IPAddress ipAddress, uint16_t portAddress);
@@ -201,6 +203,9 @@ bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest
 bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest);
 void updateFSInfo();
 void closeFile();
+void initPresetsIndex();
+void handlePresetsCompaction();
+bool readLedmapBinHeader(File &f, ledmap_bin_t &hdr, char *name = nullptr, size_t nameSize = 0);
 inline bool writeObjectToFileUsingId(const String &file, uint16_t id, JsonDocument* content) { return writeObjectToFileUsingId(file.c_str(), id, content); };
 inline bool writeObjectToFile(const String &file, const char* key, JsonDocument* content) { return writeObjectToFile(file.c_str(), key, content); };
 inline bool readObjectFromFileUsingId(const String &file, uint16_t id, JsonDocument* dest) { return readObjectFromFileUsingId(file.c_str(), id, dest); };
@@ -241,9 +246,30 @@ void handleIR();
 #include "src/dependencies/json/AsyncJson-v6.h"
 #include "FX.h"
 
+// segment properties of a JSON "seg" object with relative, random and toggle values already resolved
+// applied by applySegmentFields(), used by deserializeSegment() and the preset cache so both apply them the same way
+enum { SF_ID, SF_START, SF_STOP, SF_STARTY, SF_STOPY, SF_LEN, SF_GRP, SF_SPC, SF_OF, SF_N, SF_ON, SF_FRZ, SF_BRI, SF_BM, SF_CCT, SF_SET,
+       SF_COL, SF_FX, SF_SX, SF_IX, SF_PAL, SF_C1, SF_C2, SF_C3, SF_SEL, SF_REV, SF_MI, SF_RY, SF_MY, SF_TP, SF_O1, SF_O2, SF_O3, SF_SI, SF_M12 };
+#define SF_HAS(f, key) (((f).has >> (key)) & 1)
+#define SF_SET(f, key) ((f).has |= uint64_t(1) << (key))
+typedef struct SegmentFields {
+  uint64_t    has;                  // SF_* properties present
+  uint32_t    colors[NUM_COLORS];   // colors with bit set in colSet
+  const char *name;                 // nullptr or empty string removes name
+  int32_t     offset;
+  uint16_t    start, stop, len, startY, stopY, grp, spc, cct;
+  uint8_t     id, bri, bm, set, fx, sx, ix, pal, c1, c2, c3, si, m12;
+  uint8_t     colSet;
+  bool        on, frz, sel, rev, mi, rY, mY, tp, o1, o2, o3;
+  bool        fxdef;                // load effect defaults if effect changes
+} segfields_t;
+
+int  prepareSegmentUpdate(byte id, int stop, bool &newSeg);
+bool applySegmentFields(Segment &seg, byte id, bool newSeg, const segfields_t &f);
 bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
 void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
+void serializeStateHeader(JsonObject root, bool forPreset = false, bool includeBri = true);
 void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false);
 void serializeInfo(JsonObject root);
 void serializeModeNames(JsonArray root);
@@ -315,6 +341,7 @@ inline bool applyTemporaryPreset() {return applyPreset(255);};
 void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = JsonObject());
 inline void saveTemporaryPreset() {savePreset(255);};
 void deletePreset(byte index);
+void invalidatePresetCache();
 bool getPresetName(byte index, String& name);
 
 //remote.cpp
@@ -327,11 +354,14 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=tru
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri=255, bool isRGBW=false);
+void realtimePacketLayout(uint8_t type, bool isRGBW, size_t &headerSize, size_t &pixelsPerPacket);
+void realtimeInitPackets(uint8_t type, uint8_t *packets, uint16_t length, bool isRGBW, uint16_t startOffset=0);
+uint8_t realtimeBroadcast(uint8_t type, const IPAddress *clients, size_t numClients, uint16_t length, uint8_t *packets, uint8_t bri=255, bool isRGBW=false);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t i, unsigned count, const byte *data, unsigned channels);
 void refreshNodeList();
 void sendSysInfoUDP();
 #ifndef WLED_DISABLE_ESPNOW
@@ -447,6 +477,7 @@ class UsermodManager {
     static bool add(Usermod* um);
     static Usermod* lookup(uint16_t mod_id);
     static inline byte getModCount() {return numMods;};
+    static inline uint16_t getModId(unsigned i) { return i < numMods ? ums[i]->getId() : USERMOD_ID_UNSPECIFIED; }
 };
 
 //usermods_list.cpp
@@ -478,6 +509,10 @@ void prepareHostname(char* hostname);
 bool isAsterisksOnly(const char* str, byte maxLen);
 bool requestJSONBufferLock(uint8_t module=255);
 void releaseJSONBufferLock();
+JsonDocument *requestJSONDoc(uint8_t module, uint8_t purpose = JSON_DOC_GENERAL, size_t size = JSON_BUFFER_SIZE);
+void releaseJSONDoc(JsonDocument *doc);
+void initJSONDocPool();
+void serializeJSONDocPool(JsonArray arr);
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen);
 uint8_t extractModeSlider(uint8_t mode, uint8_t slider, char *dest, uint8_t maxLen, uint8_t *var = nullptr);
 int16_t extractModeDefaults(uint8_t mode, const char *segVar);
@@ -524,6 +559,27 @@ class JSONBufferGuard {
     inline void release() { if (holding_lock) releaseJSONBufferLock(); holding_lock = false; }
 };
 
+// RAII guard for segments and state shared between loop() (state changes) and async web server task (serializing)
+// only needed on ESP32, async callbacks do not preempt loop() on ESP8266
+#ifdef ARDUINO_ARCH_ESP32
+void lockState();
+void unlockState();
+class StateLock {
+  public:
+    inline StateLock()  { lockState(); }
+    inline ~StateLock() { unlockState(); }
+    StateLock(const StateLock&) = delete;
+    StateLock& operator=(const StateLock&) = delete;
+};
+#else
+class StateLock {
+  public:
+    inline StateLock() {}
+    StateLock(const StateLock&) = delete;
+    StateLock& operator=(const StateLock&) = delete;
+};
+#endif
+
 #ifdef WLED_ADD_EEPROM_SUPPORT
 //wled_eeprom.cpp
 void applyMacro(byte index);
@@ -32,6 +32,28 @@ static volatile size_t knownLargestSpace = MAX_SPACE;
 
 static File f; // don't export to other cpp files
 
+/*
+ * Presets file index: file offset of every preset object in presets.json, so presets can be read and
+ * replaced without searching the file. Built on first access and maintained by writeObjectToFile().
+ * It is rebuilt if the file is changed by other means (upload, /edit) which is detected by file size
+ * and cacheInvalidate. Space left by replaced or deleted presets is reclaimed by handlePresetsCompaction().
+ */
+#define PRESETS_COMPACT_MIN_WASTE 1024  // do not compact for less than this amount of padding (bytes)
+#define PRESETS_COMPACT_DELAY     10000 // ms since last preset write before compaction starts
+#define PRESETS_COMPACT_BLOCKS    4     // FS_BUFSIZE blocks copied per handlePresetsCompaction() call
+
+static struct {
+  std::vector<uint32_t> entries; // (id << 24) | offset of preset key ('"' of "<id>":), sorted by id
+  size_t        fileSize;        // presets file size the index is valid for
+  size_t        waste;           // bytes of padding in presets file
+  unsigned long lastWrite;       // millis() of last preset write
+  byte          validate;        // cacheInvalidate value when index was built
+  bool          valid;
+} presetIdx;
+
+static File compactSrc, compactDst; // presets file compaction in progress if compactDst is open
+static const char presets_tmp[] PROGMEM = "/presets.tmp";
+
 //wrapper to find out how long closing takes
 void closeFile() {
   #ifdef WLED_DEBUG_FS
@@ -161,9 +183,124 @@ static bool bufferedFindObjectEnd() {
   return false;
 }
 
+static bool isPresetsFile(const char *fileName) {
+  return strcmp_P(fileName, getPresetsFileName()) == 0;
+}
+
+// returns preset id of a "<id>": object key or -1
+static int presetIdFromKey(const char *key) {
+  if (!key || key[0] != '"' || !isdigit(key[1])) return -1;
+  int id = atoi(key + 1);
+  return (id > 0 && id < 256) ? id : -1;
+}
+
+static std::vector<uint32_t>::iterator presetIdxFind(int id) {
+  return std::lower_bound(presetIdx.entries.begin(), presetIdx.entries.end(), uint32_t(id) << 24);
+}
+
+// offset of preset key in presets file or 0 if preset does not exist
+static size_t presetIdxGet(int id) {
+  auto it = presetIdxFind(id);
+  return (it != presetIdx.entries.end() && (*it >> 24) == unsigned(id)) ? (*it & 0xFFFFFF) : 0;
+}
+
+static void presetIdxSet(int id, size_t pos) {
+  if (id < 0 || !presetIdx.valid) return;
+  if (pos > 0xFFFFFF) { presetIdx.valid = false; return; } // will not happen with supported flash sizes
+  auto it = presetIdxFind(id);
+  uint32_t entry = (uint32_t(id) << 24) | pos;
+  if (it != presetIdx.entries.end() && (*it >> 24) == unsigned(id)) *it = entry;
+  else presetIdx.entries.insert(it, entry);
+}
+
+static void presetIdxRemove(int id) {
+  auto it = presetIdxFind(id);
+  if (it != presetIdx.entries.end() && (*it >> 24) == unsigned(id)) presetIdx.entries.erase(it);
+}
+
+// positions f at preset object whose key starts at pos (skips "<id>", ':' and any whitespace)
+// returns false if file content does not match index
+static bool seekPresetIdx(size_t pos) {
+  f.seek(pos);
+  if (f.read() != '"') return false;
+  int c;
+  while ((c = f.read()) >= 0 && c != '"') if (!isdigit(c)) return false;
+  while ((c = f.read()) == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ':');
+  if (c != '{') return false;
+  f.seek(f.position() - 1);
+  return true;
+}
+
+static void abortPresetsCompaction() {
+  if (!compactDst) return;
+  compactSrc.close();
+  compactDst.close();
+  WLED_FS.remove(FPSTR(presets_tmp));
+  DEBUGFS_PRINTLN(F("Presets compaction aborted."));
+}
+
+// scans presets file (opened in f) for root level objects with numeric keys and records offsets of their keys
+// also counts whitespace outside of strings as padding
+static void buildPresetIdx() {
+  #ifdef WLED_DEBUG_FS
+    uint32_t s = millis();
+  #endif
+  presetIdx.entries.clear();
+  presetIdx.waste = 0;
+  presetIdx.valid = false;
+  if (!f) return;
+
+  byte buf[FS_BUFSIZE];
+  unsigned depth = 0;
+  bool inString = false, escape = false;
+  int key = -1;     // numeric value of current root level key, -1 if not numeric
+  size_t keyPos = 0; // offset of current root level key
+  bool keyDone = false;
+  size_t pos = 0;
+  f.seek(0);
+  while (f.available()) {
+    size_t bufsize = f.read(buf, FS_BUFSIZE);
+    for (size_t i = 0; i < bufsize; i++, pos++) {
+      const char c = buf[i];
+      if (inString) {
+        if (escape)         escape = false;
+        else if (c == '\\') escape = true;
+        else if (c == '"')  { inString = false; if (depth == 1) keyDone = true; }
+        else if (depth == 1 && key >= 0) key = isdigit(c) ? key * 10 + (c - '0') : -1;
+        continue;
+      }
+      switch (c) {
+        case ' ': case '\t': case '\n': case '\r': presetIdx.waste++; break;
+        case '"': inString = true; if (depth == 1 && !keyDone) { key = 0; keyPos = pos; } break;
+        case ':': break;
+        case '{': case '[':
+          if (depth == 1 && keyDone && key > 0 && key < 256) presetIdx.entries.push_back((uint32_t(key) << 24) | keyPos);
+          depth++;
+          keyDone = false;
+          break;
+        case '}': case ']': if (depth) depth--; break;
+        default: if (depth == 1) keyDone = false; break; // end of root level key/value pair
+      }
+    }
+  }
+  std::sort(presetIdx.entries.begin(), presetIdx.entries.end());
+  presetIdx.fileSize = f.size();
+  presetIdx.validate = cacheInvalidate;
+  presetIdx.valid    = pos < 0xFFFFFF;
+  DEBUGFS_PRINTF("Presets index: %u presets, %u bytes padding, took %d ms\n", presetIdx.entries.size(), presetIdx.waste, millis() - s);
+}
+
+// makes sure index matches presets file opened in f
+static void checkPresetIdx() {
+  if (presetIdx.valid && presetIdx.fileSize == f.size() && presetIdx.validate == cacheInvalidate) return;
+  abortPresetsCompaction(); // file was changed by other means
+  buildPresetIdx();
+}
+
 //fills n bytes from current file pos with ' ' characters
 static void writeSpace(size_t l)
 {
+  presetIdx.waste += l;
   byte buf[FS_BUFSIZE];
   memset(buf, ' ', FS_BUFSIZE);
 
@@ -176,7 +313,7 @@ static void writeSpace(size_t l)
   if (knownLargestSpace < l) knownLargestSpace = l;
 }
 
-bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint32_t contentLen = 0)
+bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint32_t contentLen = 0, int id = -1)
 {
   #ifdef WLED_DEBUG_FS
     DEBUGFS_PRINTLN(F("Append"));
@@ -201,7 +338,9 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
   DEBUGFS_PRINTF("CLen %d\n", contentLen);
   if (bufferedFindSpace(contentLen + strlen(key) + 1)) {
     if (f.position() > 2) f.write(','); //add comma if not first object
+    presetIdxSet(id, f.position());
     f.print(key);
+    presetIdx.waste -= min(presetIdx.waste, size_t(contentLen + strlen(key) + 1));
     serializeJson(*content, f);
     DEBUGFS_PRINTF("Inserted, took %d ms (total %d)", millis() - s1, millis() - s);
     doCloseFile = true;
@@ -244,6 +383,7 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
     f.print('{'); //start JSON
   }
 
+  presetIdxSet(id, f.position());
   f.print(key);
 
   //Append object
@@ -272,16 +412,32 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
   #endif
 
   size_t pos = 0;
+  size_t keyPos = 0; // offset of key if known from presets index
   char fileName[129]; strncpy_P(fileName, file, 128); fileName[128] = 0; //use PROGMEM safe copy as FS.open() does not
+  int id = isPresetsFile(fileName) ? presetIdFromKey(key) : -1;
+  if (id >= 0) abortPresetsCompaction(); // copy would be outdated
   f = WLED_FS.open(fileName, WLED_FS.exists(fileName) ? "r+" : "w+");
   if (!f) {
     DEBUGFS_PRINTLN(F("Failed to open!"));
     return false;
   }
 
-  if (!bufferedFind(key)) //key does not exist in file
+  bool found;
+  if (id >= 0) {
+    checkPresetIdx();
+    presetIdx.lastWrite = millis();
+  }
+  if (id >= 0 && presetIdx.valid) {
+    keyPos = presetIdxGet(id);
+    found = keyPos > 0 && seekPresetIdx(keyPos);
+    if (keyPos && !found) { keyPos = 0; presetIdx.valid = false; found = bufferedFind(key); } // index does not match file
+  } else found = bufferedFind(key);
+
+  if (!found) //key does not exist in file
   {
-    return appendObjectToFile(key, content, s);
+    bool success = appendObjectToFile(key, content, s, 0, id);
+    if (id >= 0) presetIdx.fileSize = f.size();
+    return success;
   }
 
   //an object with this key already exists, replace or delete it
@@ -311,15 +467,28 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
     DEBUGFS_PRINTLN(F("replace (trailing)"));
     f.seek(pos);
     serializeJson(*content, f);
+    presetIdx.waste -= min(presetIdx.waste, size_t(contentLen - oldLen));
   } else {
     DEBUGFS_PRINTLN(F("delete"));
-    pos -= strlen(key);
-    if (pos > 3) pos--; //also delete leading comma if not first object
+    pos = keyPos ? keyPos : pos - strlen(key); // there may be whitespace between key and object
+    //also delete leading comma (and any whitespace before key) if not first object
+    for (size_t p = pos; p > 3; p--) {
+      f.seek(p - 1);
+      int c = f.read();
+      if (c == ',') { pos = p - 1; break; }
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+    }
     f.seek(pos);
     writeSpace(pos2 - pos);
-    if (contentLen) return appendObjectToFile(key, content, s, contentLen);
+    if (id >= 0) presetIdxRemove(id);
+    if (contentLen) {
+      bool success = appendObjectToFile(key, content, s, contentLen, id);
+      if (id >= 0) presetIdx.fileSize = f.size();
+      return success;
+    }
   }
 
+  if (id >= 0) presetIdx.fileSize = f.size();
   doCloseFile = true;
   DEBUGFS_PRINTF("Replaced/deleted, took %d ms\n", millis() - s);
   return true;
@@ -344,7 +513,16 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest)
   f = WLED_FS.open(fileName, "r");
   if (!f) return false;
 
-  if (key != nullptr && !bufferedFind(key)) //key does not exist in file
+  int id = isPresetsFile(fileName) ? presetIdFromKey(key) : -1;
+  if (id >= 0) checkPresetIdx();
+  bool found = true;
+  if (id >= 0 && presetIdx.valid) {
+    size_t pos = presetIdxGet(id);
+    found = pos > 0 && seekPresetIdx(pos);
+    if (pos && !found) { presetIdx.valid = false; found = bufferedFind(key); } // index does not match file
+  } else if (key != nullptr) found = bufferedFind(key);
+
+  if (!found) //key does not exist in file
   {
     f.close();
     dest->clear();
@@ -359,6 +537,71 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest)
   return true;
 }
 
+// builds presets file index (called at boot, otherwise index is built on first preset access)
+void initPresetsIndex() {
+  if (doCloseFile) closeFile();
+  f = WLED_FS.open(FPSTR(getPresetsFileName()), "r");
+  if (!f) return;
+  buildPresetIdx();
+  f.close();
+}
+
+// copies presets file without padding to a temporary file (a few blocks per call, so the LEDs keep running)
+// and replaces presets file with it once done; saving a preset in the meantime aborts compaction
+void handlePresetsCompaction() {
+  static bool inString, escape;
+  static unsigned long modifiedTime; // presetsModifiedTime when compaction started (upload changes it)
+  if (!compactDst) {
+    if (!presetIdx.valid || presetIdx.waste < PRESETS_COMPACT_MIN_WASTE || presetIdx.waste * 4 < presetIdx.fileSize) return;
+    if (doCloseFile || millis() - presetIdx.lastWrite < PRESETS_COMPACT_DELAY) return;
+    if (presetIdx.validate != cacheInvalidate) return; // file was changed by other means, index will be rebuilt first
+    updateFSInfo();
+    if (presetIdx.fileSize + 9000 > (fsBytesTotal - fsBytesUsed)) return; // same margin as appendObjectToFile()
+    compactSrc = WLED_FS.open(FPSTR(getPresetsFileName()), "r");
+    if (!compactSrc) return;
+    if (compactSrc.size() != presetIdx.fileSize) { compactSrc.close(); presetIdx.valid = false; return; }
+    compactDst = WLED_FS.open(FPSTR(presets_tmp), "w");
+    if (!compactDst) { compactSrc.close(); return; }
+    inString = escape = false;
+    modifiedTime = presetsModifiedTime;
+    DEBUGFS_PRINTF("Compacting presets, %u of %u bytes padding.\n", presetIdx.waste, presetIdx.fileSize);
+  }
+
+  byte buf[FS_BUFSIZE];
+  for (unsigned b = 0; b < PRESETS_COMPACT_BLOCKS && compactSrc.available(); b++) {
+    size_t bufsize = compactSrc.read(buf, FS_BUFSIZE);
+    size_t len = 0;
+    for (size_t i = 0; i < bufsize; i++) {
+      const char c = buf[i];
+      if (inString) {
+        if (escape)         escape = false;
+        else if (c == '\\') escape = true;
+        else if (c == '"')  inString = false;
+      } else {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') continue;
+        if (c == '"') inString = true;
+      }
+      buf[len++] = c;
+    }
+    if (compactDst.write(buf, len) != len) { abortPresetsCompaction(); return; }
+  }
+  if (compactSrc.available()) return; // continue in next loop
+  if (modifiedTime != presetsModifiedTime || presetIdx.validate != cacheInvalidate) { abortPresetsCompaction(); return; } // presets file was uploaded
+
+  compactSrc.close();
+  compactDst.close();
+  char fileName[33]; strncpy_P(fileName, getPresetsFileName(), 32); fileName[32] = 0;
+  char tmpName[33];  strncpy_P(tmpName, presets_tmp, 32); tmpName[32] = 0;
+  if (!WLED_FS.rename(tmpName, fileName)) {
+    // some file systems do not replace existing file
+    WLED_FS.remove(fileName);
+    if (!WLED_FS.rename(tmpName, fileName)) errorFlag = ERR_FS_GENERAL;
+  }
+  initPresetsIndex(); // offsets have changed
+  knownLargestSpace = MAX_SPACE;
+  updateFSInfo();
+}
+
 void updateFSInfo() {
   #ifdef ARDUINO_ARCH_ESP32
     #if WLED_FS == LITTLEFS || ESP_IDF_VERSION_MAJOR >= 4
@@ -375,6 +618,18 @@ void updateFSInfo() {
   #endif
 }
 
+// reads and validates binary ledmap header (see ledmap_bin_t), file is positioned at start of map data on success
+// name (if not nullptr) receives zero terminated ledmap name (empty if file has none)
+bool readLedmapBinHeader(File &file, ledmap_bin_t &hdr, char *name, size_t nameSize) {
+  if (!file || file.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+  if (memcmp(hdr.magic, LEDMAP_BIN_MAGIC, sizeof(hdr.magic)) || hdr.version != LEDMAP_BIN_VERSION || hdr.encoding > LEDMAP_BIN_RUNS || hdr.nameLen > 32) return false;
+  char tmp[33];
+  if (file.read((uint8_t*)tmp, hdr.nameLen) != hdr.nameLen) return false;
+  tmp[hdr.nameLen] = '\0';
+  if (name && nameSize) strlcpy(name, tmp, nameSize);
+  return true;
+}
+
 
 #ifdef ARDUINO_ARCH_ESP32
 // caching presets in PSRAM may prevent occasional flashes seen when HomeAssitant polls WLED
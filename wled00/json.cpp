@@ -10,31 +10,141 @@
 #define JSON_PATH_FXDATA     6
 #define JSON_PATH_NETWORKS   7
 #define JSON_PATH_EFFECTS    8
+#define JSON_PATH_PERF       9
 
 /*
  * JSON API (De)serialization
  */
 
-bool deserializeSegment(JsonObject elem, byte it, byte presetId)
+// returns index of segment to update (a new segment is appended if id is beyond the last one), -1 if there is nothing to update
+int prepareSegmentUpdate(byte id, int stop, bool &newSeg)
 {
-  byte id = elem["id"] | it;
-  if (id >= strip.getMaxSegments()) return false;
-
-  bool newSeg = false;
-  int stop = elem["stop"] | -1;
+  newSeg = false;
+  if (id >= strip.getMaxSegments()) return -1;
 
   // append segment
   if (id >= strip.getSegmentsNum()) {
-    if (stop <= 0) return false; // ignore empty/inactive segments
+    if (stop <= 0) return -1; // ignore empty/inactive segments
     strip.appendSegment(Segment(0, strip.getLengthTotal()));
     id = strip.getSegmentsNum()-1; // segments are added at the end of list
     newSeg = true;
   }
+  return id;
+}
+
+// applies resolved segment properties, returns false if segment was deleted (and is marked for reset)
+// strip needs to be suspended for this to work without issues
+bool applySegmentFields(Segment &seg, byte id, bool newSeg, const segfields_t &f)
+{
+  int start = SF_HAS(f, SF_START) ? f.start : seg.start;
+  int stop  = SF_HAS(f, SF_STOP)  ? f.stop  : ((SF_HAS(f, SF_LEN) && f.len > 0) ? start + f.len : seg.stop);
+  // 2D segments
+  int startY = SF_HAS(f, SF_STARTY) ? f.startY : seg.startY;
+  int stopY  = SF_HAS(f, SF_STOPY)  ? f.stopY  : seg.stopY;
+
+  if (SF_HAS(f, SF_N) || start != seg.start || stop != seg.stop) {
+    // clear old name (also when clearing or setting segment without name field)
+    delete[] seg.name;
+    seg.name = nullptr;
+    size_t len = (SF_HAS(f, SF_N) && f.name) ? strnlen(f.name, WLED_MAX_SEGNAME_LEN) : 0;
+    if (len > 0) {
+      seg.name = new char[len+1];
+      if (seg.name) strlcpy(seg.name, f.name, len+1);
+    }
+  }
+
+  uint16_t grp = SF_HAS(f, SF_GRP) ? f.grp : seg.grouping;
+  uint16_t spc = SF_HAS(f, SF_SPC) ? f.spc : seg.spacing;
+  uint16_t of  = seg.offset;
+  uint8_t  map1D2D = SF_HAS(f, SF_M12) ? f.m12 : seg.map1D2D;
+  if (SF_HAS(f, SF_SET)) seg.set      = constrain(f.set, 0, 3);
+  if (SF_HAS(f, SF_SI))  seg.soundSim = constrain(f.si, 0, 3);
+
+  int len = (stop > start) ? stop - start : 1;
+  if (SF_HAS(f, SF_OF)) {
+    int offsetAbs = abs(f.offset);
+    if (offsetAbs > len - 1) offsetAbs %= len;
+    if (f.offset < 0) offsetAbs = len - offsetAbs;
+    of = offsetAbs;
+  }
+  if (stop > start && of > len -1) of = len -1;
+
+  // update segment (delete if necessary)
+  seg.setGeometry(start, stop, grp, spc, of, startY, stopY, map1D2D);
+
+  if (newSeg) seg.refreshLightCapabilities(); // fix for #3403
+
+  if (seg.reset && seg.stop == 0) {
+    if (id == strip.getMainSegmentId()) strip.setMainSegmentId(0); // fix for #3403
+    return false; // segment was deleted & is marked for reset, no need to change anything else
+  }
+
+  if (SF_HAS(f, SF_BRI)) {
+    if (f.bri > 0) seg.setOpacity(f.bri);
+    seg.setOption(SEG_OPTION_ON, f.bri); // use transition
+  }
+  if (SF_HAS(f, SF_ON))  seg.setOption(SEG_OPTION_ON, f.on); // use transition
+  if (SF_HAS(f, SF_FRZ)) seg.freeze = f.frz;
+  if (SF_HAS(f, SF_BM))  seg.blendMode = f.bm < BLEND_MODE_COUNT ? f.bm : BLEND_MODE_NORMAL;
+  if (SF_HAS(f, SF_CCT)) seg.setCCT(f.cct);
+
+  if (SF_HAS(f, SF_COL)) {
+    if (seg.getLightCapabilities() & 3) {
+      // segment has RGB or White
+      for (size_t i = 0; i < NUM_COLORS; i++) {
+        if (!(f.colSet & (1 << i))) continue;
+        seg.setColor(i, f.colors[i]);
+        if (seg.mode == FX_MODE_STATIC) strip.trigger(); //instant refresh
+      }
+    } else {
+      // non RGB & non White segment (usually On/Off bus)
+      seg.setColor(0, ULTRAWHITE);
+      seg.setColor(1, BLACK);
+    }
+  }
+
+  #ifndef WLED_DISABLE_2D
+  bool reverse   = seg.reverse;
+  bool mirror    = seg.mirror;
+  bool reverse_y = seg.reverse_y;
+  bool mirror_y  = seg.mirror_y;
+  #endif
+  if (SF_HAS(f, SF_SEL)) seg.selected  = f.sel;
+  if (SF_HAS(f, SF_REV)) seg.reverse   = f.rev;
+  if (SF_HAS(f, SF_MI))  seg.mirror    = f.mi;
+  #ifndef WLED_DISABLE_2D
+  if (SF_HAS(f, SF_RY))  seg.reverse_y = f.rY;
+  if (SF_HAS(f, SF_MY))  seg.mirror_y  = f.mY;
+  if (SF_HAS(f, SF_TP))  seg.transpose = f.tp;
+  if (seg.is2D() && seg.map1D2D == M12_pArc && (reverse != seg.reverse || reverse_y != seg.reverse_y || mirror != seg.mirror || mirror_y != seg.mirror_y)) seg.fill(BLACK); // clear entire segment (in case of Arc 1D to 2D expansion)
+  #endif
+
+  if (SF_HAS(f, SF_FX) && f.fx != seg.mode) seg.setMode(f.fx, f.fxdef);
+  if (SF_HAS(f, SF_SX)) seg.speed     = f.sx;
+  if (SF_HAS(f, SF_IX)) seg.intensity = f.ix;
+  if (SF_HAS(f, SF_PAL) && (seg.getLightCapabilities() & 1)) seg.setPalette(f.pal); // ignore palette for White and On/Off segments
+  if (SF_HAS(f, SF_C1)) seg.custom1 = f.c1;
+  if (SF_HAS(f, SF_C2)) seg.custom2 = f.c2;
+  if (SF_HAS(f, SF_C3)) seg.custom3 = constrain(f.c3, 0, 31);
+  if (SF_HAS(f, SF_O1)) seg.check1  = f.o1;
+  if (SF_HAS(f, SF_O2)) seg.check2  = f.o2;
+  if (SF_HAS(f, SF_O3)) seg.check3  = f.o3;
+  return true;
+}
+
+bool deserializeSegment(JsonObject elem, byte it, byte presetId)
+{
+  byte id = elem["id"] | it;
+  int stop = elem["stop"] | -1;
+  bool newSeg = false;
+  int idx = prepareSegmentUpdate(id, stop, newSeg);
+  if (idx < 0) return false;
+  id = idx;
 
   //DEBUG_PRINTLN(F("-- JSON deserialize segment."));
   Segment& seg = strip.getSegment(id);
   //DEBUG_PRINTF_P(PSTR("--  Original segment: %p (%p)\n"), &seg, seg.data);
-  const Segment prev = seg; //make a backup so we can tell if something changed (calling copy constructor)
+  const Segment prev(seg, false); //make a backup so we can tell if something changed (without effect data and pixels)
   //DEBUG_PRINTF_P(PSTR("--  Duplicate segment: %p (%p)\n"), &prev, prev.data);
 
   int start = elem["start"] | seg.start;
@@ -42,9 +152,6 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     int len = elem["len"];
     stop = (len > 0) ? start + len : seg.stop;
   }
-  // 2D segments
-  int startY = elem["startY"] | seg.startY;
-  int stopY = elem["stopY"] | seg.stopY;
 
   //repeat, multiplies segment until all LEDs are used, or max segments reached
   bool repeat = elem["rpt"] | false;
@@ -65,129 +172,121 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     return true;
   }
 
+  // resolve relative, random and toggle values against current segment
+  segfields_t f = {};
+  f.start  = start;                       SF_SET(f, SF_START);
+  f.stop   = stop;                        SF_SET(f, SF_STOP);
+  f.startY = elem["startY"] | seg.startY; SF_SET(f, SF_STARTY);
+  f.stopY  = elem["stopY"]  | seg.stopY;  SF_SET(f, SF_STOPY);
+
   if (elem["n"]) {
     // name field exists
-    if (seg.name) { //clear old name
-      delete[] seg.name;
-      seg.name = nullptr;
-    }
-
-    const char * name = elem["n"].as<const char*>();
-    size_t len = 0;
-    if (name != nullptr) len = strlen(name);
-    if (len > 0) {
-      if (len > WLED_MAX_SEGNAME_LEN) len = WLED_MAX_SEGNAME_LEN;
-      seg.name = new char[len+1];
-      if (seg.name) strlcpy(seg.name, name, WLED_MAX_SEGNAME_LEN+1);
-    } else {
-      // but is empty (already deleted above)
+    f.name = elem["n"].as<const char*>();
+    SF_SET(f, SF_N);
+    if (f.name == nullptr || f.name[0] == '\0') {
+      // but is empty (old name is deleted)
+      f.name = nullptr;
       elem.remove("n");
     }
-  } else if (start != seg.start || stop != seg.stop) {
-    // clearing or setting segment without name field
-    if (seg.name) {
-      delete[] seg.name;
-      seg.name = nullptr;
-    }
-  }
-
-  uint16_t grp = elem["grp"] | seg.grouping;
-  uint16_t spc = elem[F("spc")] | seg.spacing;
-  uint16_t of  = seg.offset;
-  uint8_t  soundSim = elem["si"] | seg.soundSim;
-  uint8_t  map1D2D  = elem["m12"] | seg.map1D2D;
-  uint8_t  set = elem[F("set")] | seg.set;
-  seg.set      = constrain(set, 0, 3);
-  seg.soundSim = constrain(soundSim, 0, 3);
-
-  int len = (stop > start) ? stop - start : 1;
-  int offset = elem[F("of")] | INT32_MAX;
-  if (offset != INT32_MAX) {
-    int offsetAbs = abs(offset);
-    if (offsetAbs > len - 1) offsetAbs %= len;
-    if (offset < 0) offsetAbs = len - offsetAbs;
-    of = offsetAbs;
   }
-  if (stop > start && of > len -1) of = len -1;
-
-  // update segment (delete if necessary)
-  seg.setGeometry(start, stop, grp, spc, of, startY, stopY, map1D2D); // strip needs to be suspended for this to work without issues
 
-  if (newSeg) seg.refreshLightCapabilities(); // fix for #3403
-
-  if (seg.reset && seg.stop == 0) {
-    if (id == strip.getMainSegmentId()) strip.setMainSegmentId(0); // fix for #3403
-    return true; // segment was deleted & is marked for reset, no need to change anything else
-  }
-
-  byte segbri = seg.opacity;
-  if (getVal(elem["bri"], &segbri)) {
-    if (segbri > 0) seg.setOpacity(segbri);
-    seg.setOption(SEG_OPTION_ON, segbri); // use transition
-  }
-
-  seg.setOption(SEG_OPTION_ON, getBoolVal(elem["on"], seg.on)); // use transition
-  seg.freeze = getBoolVal(elem["frz"], seg.freeze);
-
-  seg.setCCT(elem["cct"] | seg.cct);
+  f.grp = elem["grp"]    | seg.grouping; SF_SET(f, SF_GRP);
+  f.spc = elem[F("spc")] | seg.spacing;  SF_SET(f, SF_SPC);
+  f.si  = elem["si"]     | seg.soundSim; SF_SET(f, SF_SI);
+  f.m12 = elem["m12"]    | seg.map1D2D;  SF_SET(f, SF_M12);
+  f.set = elem[F("set")] | seg.set;      SF_SET(f, SF_SET);
+  f.offset = elem[F("of")] | INT32_MAX;
+  if (f.offset != INT32_MAX) SF_SET(f, SF_OF);
+
+  f.bri = seg.opacity;
+  if (getVal(elem["bri"], &f.bri)) SF_SET(f, SF_BRI);
+  f.on  = getBoolVal(elem["on"], SF_HAS(f, SF_BRI) ? f.bri > 0 : seg.on); SF_SET(f, SF_ON); // toggles state after brightness is applied
+  f.frz = getBoolVal(elem["frz"], seg.freeze); SF_SET(f, SF_FRZ);
+  f.bm  = elem["bm"]  | seg.blendMode;         SF_SET(f, SF_BM);
+  f.cct = elem["cct"] | seg.cct;               SF_SET(f, SF_CCT);
 
   JsonArray colarr = elem["col"];
   if (!colarr.isNull())
   {
-    if (seg.getLightCapabilities() & 3) {
-      // segment has RGB or White
-      for (size_t i = 0; i < NUM_COLORS; i++) {
-        // JSON "col" array can contain the following values for each of segment's colors (primary, background, custom):
-        // "col":[int|string|object|array, int|string|object|array, int|string|object|array]
-        //   int = Kelvin temperature or 0 for black
-        //   string = hex representation of [WW]RRGGBB
-        //   object = individual channel control {"r":0,"g":127,"b":255,"w":255}, each being optional (valid to send {})
-        //   array = direct channel values [r,g,b,w] (w element being optional)
-        int rgbw[] = {0,0,0,0};
-        bool colValid = false;
-        JsonArray colX = colarr[i];
-        if (colX.isNull()) {
-          JsonObject oCol = colarr[i];
-          if (!oCol.isNull()) {
-            // we have a JSON object for color {"w":123,"r":123,...}; allows individual channel control
-            rgbw[0] = oCol["r"] | R(seg.colors[i]);
-            rgbw[1] = oCol["g"] | G(seg.colors[i]);
-            rgbw[2] = oCol["b"] | B(seg.colors[i]);
-            rgbw[3] = oCol["w"] | W(seg.colors[i]);
+    SF_SET(f, SF_COL);
+    for (size_t i = 0; i < NUM_COLORS; i++) {
+      // JSON "col" array can contain the following values for each of segment's colors (primary, background, custom):
+      // "col":[int|string|object|array, int|string|object|array, int|string|object|array]
+      //   int = Kelvin temperature or 0 for black
+      //   string = hex representation of [WW]RRGGBB
+      //   object = individual channel control {"r":0,"g":127,"b":255,"w":255}, each being optional (valid to send {})
+      //   array = direct channel values [r,g,b,w] (w element being optional)
+      int rgbw[] = {0,0,0,0};
+      bool colValid = false;
+      JsonArray colX = colarr[i];
+      if (colX.isNull()) {
+        JsonObject oCol = colarr[i];
+        if (!oCol.isNull()) {
+          // we have a JSON object for color {"w":123,"r":123,...}; allows individual channel control
+          rgbw[0] = oCol["r"] | R(seg.colors[i]);
+          rgbw[1] = oCol["g"] | G(seg.colors[i]);
+          rgbw[2] = oCol["b"] | B(seg.colors[i]);
+          rgbw[3] = oCol["w"] | W(seg.colors[i]);
+          colValid = true;
+        } else {
+          byte brgbw[] = {0,0,0,0};
+          const char* hexCol = colarr[i];
+          if (hexCol == nullptr) { //Kelvin color temperature (or invalid), e.g 2400
+            int kelvin = colarr[i] | -1;
+            if (kelvin <  0) continue;
+            if (kelvin >  0) colorKtoRGB(kelvin, brgbw);
             colValid = true;
-          } else {
-            byte brgbw[] = {0,0,0,0};
-            const char* hexCol = colarr[i];
-            if (hexCol == nullptr) { //Kelvin color temperature (or invalid), e.g 2400
-              int kelvin = colarr[i] | -1;
-              if (kelvin <  0) continue;
-              if (kelvin == 0) seg.setColor(i, 0);
-              if (kelvin >  0) colorKtoRGB(kelvin, brgbw);
-              colValid = true;
-            } else { //HEX string, e.g. "FFAA00"
-              colValid = colorFromHexString(brgbw, hexCol);
-            }
-            for (size_t c = 0; c < 4; c++) rgbw[c] = brgbw[c];
+          } else { //HEX string, e.g. "FFAA00"
+            colValid = colorFromHexString(brgbw, hexCol);
           }
-        } else { //Array of ints (RGB or RGBW color), e.g. [255,160,0]
-          byte sz = colX.size();
-          if (sz == 0) continue; //do nothing on empty array
-          copyArray(colX, rgbw, 4);
-          colValid = true;
+          for (size_t c = 0; c < 4; c++) rgbw[c] = brgbw[c];
         }
-
-        if (!colValid) continue;
-
-        seg.setColor(i, RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]));
-        if (seg.mode == FX_MODE_STATIC) strip.trigger(); //instant refresh
+      } else { //Array of ints (RGB or RGBW color), e.g. [255,160,0]
+        byte sz = colX.size();
+        if (sz == 0) continue; //do nothing on empty array
+        copyArray(colX, rgbw, 4);
+        colValid = true;
       }
-    } else {
-      // non RGB & non White segment (usually On/Off bus)
-      seg.setColor(0, ULTRAWHITE);
-      seg.setColor(1, BLACK);
+
+      if (!colValid) continue;
+      f.colors[i] = RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
+      f.colSet |= 1 << i;
     }
   }
 
+  f.sel = getBoolVal(elem["sel"], seg.selected);     SF_SET(f, SF_SEL);
+  f.rev = getBoolVal(elem["rev"], seg.reverse);      SF_SET(f, SF_REV);
+  f.mi  = getBoolVal(elem["mi"] , seg.mirror);       SF_SET(f, SF_MI);
+  #ifndef WLED_DISABLE_2D
+  f.rY  = getBoolVal(elem["rY"]   , seg.reverse_y);  SF_SET(f, SF_RY);
+  f.mY  = getBoolVal(elem["mY"]   , seg.mirror_y);   SF_SET(f, SF_MY);
+  f.tp  = getBoolVal(elem[F("tp")], seg.transpose);  SF_SET(f, SF_TP);
+  #endif
+
+  f.fx = seg.mode;
+  if (getVal(elem["fx"], &f.fx, 0, strip.getModeCount())) {
+    if (!presetId && currentPlaylist>=0) unloadPlaylist();
+    f.fxdef = elem[F("fxdef")];
+    SF_SET(f, SF_FX);
+  }
+  f.sx = seg.speed;
+  if (getVal(elem["sx"], &f.sx)) SF_SET(f, SF_SX);
+  f.ix = seg.intensity;
+  if (getVal(elem["ix"], &f.ix)) SF_SET(f, SF_IX);
+  f.pal = seg.palette;
+  if (getVal(elem["pal"], &f.pal, 0, strip.getPaletteCount())) SF_SET(f, SF_PAL);
+  f.c1 = seg.custom1;
+  if (getVal(elem["c1"], &f.c1)) SF_SET(f, SF_C1);
+  f.c2 = seg.custom2;
+  if (getVal(elem["c2"], &f.c2)) SF_SET(f, SF_C2);
+  f.c3 = seg.custom3;
+  if (getVal(elem["c3"], &f.c3, 0, 31)) SF_SET(f, SF_C3);
+  f.o1 = getBoolVal(elem["o1"], seg.check1); SF_SET(f, SF_O1);
+  f.o2 = getBoolVal(elem["o2"], seg.check2); SF_SET(f, SF_O2);
+  f.o3 = getBoolVal(elem["o3"], seg.check3); SF_SET(f, SF_O3);
+
+  if (!applySegmentFields(seg, id, newSeg, f)) return true; // segment was deleted
+
   // lx parser
   #ifdef WLED_ENABLE_LOXONE
   int lx = elem[F("lx")] | -1;
@@ -200,46 +299,6 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   }
   #endif
 
-  #ifndef WLED_DISABLE_2D
-  bool reverse  = seg.reverse;
-  bool mirror   = seg.mirror;
-  #endif
-  seg.selected  = getBoolVal(elem["sel"], seg.selected);
-  seg.reverse   = getBoolVal(elem["rev"], seg.reverse);
-  seg.mirror    = getBoolVal(elem["mi"] , seg.mirror);
-  #ifndef WLED_DISABLE_2D
-  bool reverse_y = seg.reverse_y;
-  bool mirror_y  = seg.mirror_y;
-  seg.reverse_y  = getBoolVal(elem["rY"]   , seg.reverse_y);
-  seg.mirror_y   = getBoolVal(elem["mY"]   , seg.mirror_y);
-  seg.transpose  = getBoolVal(elem[F("tp")], seg.transpose);
-  if (seg.is2D() && seg.map1D2D == M12_pArc && (reverse != seg.reverse || reverse_y != seg.reverse_y || mirror != seg.mirror || mirror_y != seg.mirror_y)) seg.fill(BLACK); // clear entire segment (in case of Arc 1D to 2D expansion)
-  #endif
-
-  byte fx = seg.mode;
-  if (getVal(elem["fx"], &fx, 0, strip.getModeCount())) {
-    if (!presetId && currentPlaylist>=0) unloadPlaylist();
-    if (fx != seg.mode) seg.setMode(fx, elem[F("fxdef")]);
-  }
-
-  getVal(elem["sx"], &seg.speed);
-  getVal(elem["ix"], &seg.intensity);
-
-  uint8_t pal = seg.palette;
-  if (seg.getLightCapabilities() & 1) {  // ignore palette for White and On/Off segments
-    if (getVal(elem["pal"], &pal, 0, strip.getPaletteCount())) seg.setPalette(pal);
-  }
-
-  getVal(elem["c1"], &seg.custom1);
-  getVal(elem["c2"], &seg.custom2);
-  uint8_t cust3 = seg.custom3;
-  getVal(elem["c3"], &cust3, 0, 31); // we can't pass reference to bitfield
-  seg.custom3 = constrain(cust3, 0, 31);
-
-  seg.check1 = getBoolVal(elem["o1"], seg.check1);
-  seg.check2 = getBoolVal(elem["o2"], seg.check2);
-  seg.check3 = getBoolVal(elem["o3"], seg.check3);
-
   JsonArray iarr = elem[F("i")]; //set individual LEDs
   if (!iarr.isNull()) {
     uint8_t oldMap1D2D = seg.map1D2D;
@@ -258,7 +317,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     }
 
     start = 0, stop = 0;
-    set = 0; //0 nothing set, 1 start set, 2 range set
+    unsigned set = 0; //0 nothing set, 1 start set, 2 range set
 
     for (size_t i = 0; i < iarr.size(); i++) {
       if(iarr[i].is<JsonInteger>()) {
@@ -302,6 +361,7 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
 // presetId is non-0 if called from handlePreset()
 bool deserializeState(JsonObject root, byte callMode, byte presetId)
 {
+  StateLock stateLock; // async web server task may be serializing segments
   bool stateResponse = root[F("v")] | false;
 
   #if defined(WLED_DEBUG) && defined(WLED_DEBUG_HOST)
@@ -336,6 +396,11 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     }
   }
 
+#ifndef WLED_DISABLE_MODE_BLEND
+  blendingStyle = root[F("bs")] | blendingStyle;
+  if (blendingStyle >= BLEND_STYLE_COUNT) blendingStyle = BLEND_STYLE_FADE;
+#endif
+
   // temporary transition (applies only once)
   tr = root[F("tt")] | -1;
   if (tr >= 0) {
@@ -514,6 +579,7 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["frz"]    = seg.freeze;
   byte segbri    = seg.opacity;
   root["bri"]    = (segbri) ? segbri : 255;
+  root["bm"]     = seg.blendMode;
   root["cct"]    = seg.cct;
   root[F("set")] = seg.set;
 
@@ -562,13 +628,17 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["m12"] = seg.map1D2D;
 }
 
-void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly)
+// everything in state except segments
+void serializeStateHeader(JsonObject root, bool forPreset, bool includeBri)
 {
   if (includeBri) {
     root["on"] = (bri > 0);
     root["bri"] = briLast;
     root[F("transition")] = transitionDelay/100; //in 100ms
   }
+#ifndef WLED_DISABLE_MODE_BLEND
+  root[F("bs")] = blendingStyle;
+#endif
 
   if (!forPreset) {
     if (errorFlag) {root[F("error")] = errorFlag; errorFlag = ERR_NONE;} //prevent error message to persist on screen
@@ -596,6 +666,11 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 
   root[F("mainseg")] = strip.getMainSegmentId();
+}
+
+void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly)
+{
+  serializeStateHeader(root, forPreset, includeBri);
 
   JsonArray seg = root.createNestedArray("seg");
   for (size_t s = 0; s < strip.getMaxSegments(); s++) {
@@ -632,6 +707,15 @@ void serializeInfo(JsonObject root)
   leds["fps"] = strip.getFps();
   leds[F("maxpwr")] = BusManager::currentMilliamps()>0 ? BusManager::ablMilliampsMax() : 0;
   leds[F("maxseg")] = strip.getMaxSegments();
+  const DataArena &arena = Segment::getDataArena(); // effect data memory and its fragmentation
+  JsonObject fxdata = leds.createNestedObject(F("fxdata"));
+  fxdata[F("size")] = arena.getSize();
+  fxdata[F("used")] = arena.getUsed();
+  fxdata[F("heap")] = arena.getHeapUsed();
+  fxdata[F("lfree")] = arena.getLargestFree();
+  fxdata[F("holes")] = arena.getHoles();
+  fxdata[F("cmp")]  = arena.getCompactions();
+  fxdata[F("fail")] = arena.getFailed();
   //leds[F("actseg")] = strip.getActiveSegmentsNum();
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
   leds[F("bootps")] = bootPreset;
@@ -691,6 +775,10 @@ void serializeInfo(JsonObject root)
   }
 
   root[F("lip")] = realtimeIP[0] == 0 ? "" : realtimeIP.toString();
+  JsonObject rtFrames = root.createNestedObject(F("lfr")); // realtime frame statistics
+  rtFrames[F("shown")]   = realtimeFramesShown;
+  rtFrames[F("partial")] = realtimeFramesPartial;
+  rtFrames[F("late")]    = realtimePacketsLate;
 
   #ifdef WLED_ENABLE_WEBSOCKETS
   root[F("ws")] = ws.count();
@@ -769,6 +857,9 @@ void serializeInfo(JsonObject root)
   getTimeString(time);
   root[F("time")] = time;
 
+  PerfMonitor::serialize(root.createNestedObject(F("perf")), false); // summary, see /json/perf for details
+  serializeJSONDocPool(root.createNestedArray(F("jdoc")));
+
   UsermodManager::addToJsonInfo(root);
 
   uint16_t os = 0;
@@ -997,28 +1088,245 @@ void serializeModeNames(JsonArray arr)
   }
 }
 
-// Global buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
+// Pooled buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
 class LockedJsonResponse: public AsyncJsonResponse {
+  JsonDocument *_doc;
   bool _holding_lock;
   public:
-  // WARNING: constructor assumes requestJSONBufferLock() was successfully acquired externally/prior to constructing the instance
+  // WARNING: constructor assumes requestJSONDoc() was successfully acquired externally/prior to constructing the instance
   // Not a good practice with C++. Unfortunately AsyncJsonResponse only has 2 constructors - for dynamic buffer or existing buffer,
   // with existing buffer it clears its content during construction
   // if the lock was not acquired (using JSONBufferGuard class) previous implementation still cleared existing buffer
-  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _holding_lock(true) {};
+  inline LockedJsonResponse(JsonDocument* doc, bool isArray) : AsyncJsonResponse(doc, isArray), _doc(doc), _holding_lock(true) {};
 
   virtual size_t _fillBuffer(uint8_t *buf, size_t maxLen) { 
     size_t result = AsyncJsonResponse::_fillBuffer(buf, maxLen);
     // Release lock as soon as we're done filling content
     if (((result + _sentLength) >= (_contentLength)) && _holding_lock) {
-      releaseJSONBufferLock();
+      releaseJSONDoc(_doc);
       _holding_lock = false;
     }
     return result;
   }
 
   // destructor will remove JSON buffer lock when response is destroyed in AsyncWebServer
-  virtual ~LockedJsonResponse() { if (_holding_lock) releaseJSONBufferLock(); };
+  virtual ~LockedJsonResponse() { if (_holding_lock) releaseJSONDoc(_doc); };
+};
+
+/*
+ * Streaming JSON response for state, info, effect names and effect data
+ * The response is generated part by part while it is being sent (state header, a single segment, info,
+ * a batch of effect names...) so no JSON document or buffer lock is held while a (slow) client receives it.
+ * Each part is serialized under StateLock so loop() can not change segments in the middle of a part.
+ * Peak memory is the size of the largest part (usually info) instead of JSON_BUFFER_SIZE.
+ */
+#define JSON_STREAM_PART 512  // effect names/data and palette names are sent in batches of this size
+#define JSON_STREAM_DOC  1024 // initial JSON document size for a part, grown up to JSON_BUFFER_SIZE if it overflows
+
+// parts of streamed response
+#define JSS_END          0
+#define JSS_KEY_STATE    1
+#define JSS_KEY_INFO     2
+#define JSS_KEY_EFFECTS  3
+#define JSS_KEY_PALETTES 4
+#define JSS_CLOSE        5
+#define JSS_STATE        6 // state without segments
+#define JSS_SEGMENTS     7 // one segment per part
+#define JSS_INFO         8
+#define JSS_NAMES        9
+#define JSS_FXDATA      10
+#define JSS_PALETTES    11
+
+static const uint8_t jsonStreamState[]     = {JSS_STATE, JSS_SEGMENTS, JSS_END};
+static const uint8_t jsonStreamInfo[]      = {JSS_INFO, JSS_END};
+static const uint8_t jsonStreamEffects[]   = {JSS_NAMES, JSS_END};
+static const uint8_t jsonStreamFxData[]    = {JSS_FXDATA, JSS_END};
+static const uint8_t jsonStreamStateInfo[] = {JSS_KEY_STATE, JSS_STATE, JSS_SEGMENTS, JSS_KEY_INFO, JSS_INFO, JSS_CLOSE, JSS_END};
+static const uint8_t jsonStreamAll[]       = {JSS_KEY_STATE, JSS_STATE, JSS_SEGMENTS, JSS_KEY_INFO, JSS_INFO,
+                                              JSS_KEY_EFFECTS, JSS_NAMES, JSS_KEY_PALETTES, JSS_PALETTES, JSS_CLOSE, JSS_END};
+
+class JsonStreamResponse: public AsyncAbstractResponse {
+  const uint8_t *_stage; // current part, see JSS_*
+  size_t   _index;       // position within current part (segment, effect or character)
+  unsigned _items;       // items already written to current array
+  char    *_buf;         // text of current part
+  size_t   _size;
+  size_t   _len;
+  size_t   _pos;         // bytes of current part already sent
+
+  bool reserve(size_t len) {
+    if (len <= _size) return true;
+    size_t size = std::max(len, 2*_size);
+    char *buf = (char*)realloc(_buf, size);
+    if (!buf) return false;
+    _buf = buf;
+    _size = size;
+    return true;
+  }
+
+  void append(const char *str, size_t len) {
+    if (!reserve(_len + len)) return;
+    memcpy(_buf + _len, str, len);
+    _len += len;
+  }
+
+  void append_P(const char *str) {
+    size_t len = strlen_P(str);
+    if (!reserve(_len + len)) return;
+    memcpy_P(_buf + _len, str, len);
+    _len += len;
+  }
+
+  // quoted & escaped JSON string
+  void appendString(const char *str) {
+    append("\"", 1);
+    for (; *str; str++) {
+      if (*str == '"' || *str == '\\') {
+        char esc[2] = {'\\', *str};
+        append(esc, 2);
+      } else if ((uint8_t)*str < 0x20) {
+        char esc[7];
+        sprintf_P(esc, PSTR("\\u%04x"), (unsigned)*str);
+        append(esc, 6);
+      } else
+        append(str, 1);
+    }
+    append("\"", 1);
+  }
+
+  // serializes state header, a single segment or info using a temporary JSON document
+  bool appendDoc(uint8_t part, unsigned segId = 0) {
+    byte err = errorFlag; // serializeStateHeader() clears it
+    size_t size = JSON_STREAM_DOC;
+    while (true) {
+      PSRAMDynamicJsonDocument doc(size);
+      if (doc.capacity() == 0) return false;
+      JsonObject root = doc.to<JsonObject>();
+      {
+        StateLock stateLock; // loop() may be changing or purging segments, lock is held only for one part
+        switch (part) {
+          case JSS_STATE:    serializeStateHeader(root, false, true); break;
+          case JSS_SEGMENTS: serializeSegment(root, strip.getSegment(segId), segId); break;
+          default:           serializeInfo(root); break;
+        }
+      }
+      if (!doc.overflowed()) {
+        size_t len = measureJson(doc);
+        if (!reserve(_len + len + 1)) return false;
+        _len += serializeJson(doc, _buf + _len, len + 1);
+        return true;
+      }
+      if (size >= JSON_BUFFER_SIZE) return false;
+      errorFlag = err;
+      size = std::min(2*size, (size_t)JSON_BUFFER_SIZE);
+    }
+  }
+
+  // adds a batch of effect names (or effect data), returns true when all effects were added
+  bool appendModes(bool fxData) {
+    char lineBuffer[256];
+    if (_index == 0) append("[", 1);
+    while (_index < strip.getModeCount() && _len < JSON_STREAM_PART) {
+      strncpy_P(lineBuffer, strip.getModeData(_index++), sizeof(lineBuffer)/sizeof(char)-1);
+      lineBuffer[sizeof(lineBuffer)/sizeof(char)-1] = '\0'; // terminate string
+      if (lineBuffer[0] == 0) continue;
+      char *dataPtr = strchr(lineBuffer,'@');
+      if (_items++) append(",", 1);
+      if (fxData) {
+        appendString(dataPtr ? dataPtr+1 : "");
+      } else {
+        if (dataPtr) *dataPtr = 0; // remove effect data from name
+        appendString(lineBuffer);
+      }
+    }
+    if (_index < strip.getModeCount()) return false;
+    append("]", 1);
+    return true;
+  }
+
+  // generates next part into buffer, returns false if response is complete
+  bool nextPart() {
+    _len = _pos = 0;
+    while (_len == 0) {
+      bool done = true; // part completed, advance to next one
+      switch (*_stage) {
+        case JSS_END:          return false;
+        case JSS_KEY_STATE:    append_P(PSTR("{\"state\":"));     break;
+        case JSS_KEY_INFO:     append_P(PSTR(",\"info\":"));      break;
+        case JSS_KEY_EFFECTS:  append_P(PSTR(",\"effects\":"));   break;
+        case JSS_KEY_PALETTES: append_P(PSTR(",\"palettes\":"));  break;
+        case JSS_CLOSE:        append("}", 1);                    break;
+        case JSS_STATE:
+          if (appendDoc(JSS_STATE)) _len--;       // remove closing brace, segments follow
+          else append_P(PSTR("{\"error\":3"));   // ERR_NOBUF
+          append_P(PSTR(",\"seg\":["));
+          break;
+        case JSS_SEGMENTS: {
+          // segments may be added or removed while the response is sent, but not between check and serialization
+          StateLock stateLock;
+          while (_index < strip.getSegmentsNum() && !strip.getSegment(_index).isActive()) _index++;
+          if (_index < strip.getSegmentsNum()) {
+            if (_items) append(",", 1);
+            if (appendDoc(JSS_SEGMENTS, _index)) _items++;
+            else _len = 0;
+            _index++;
+            done = false;
+          } else
+            append("]}", 2);
+        } break;
+        case JSS_INFO:
+          if (!appendDoc(JSS_INFO)) append_P(PSTR("{\"error\":3}")); // ERR_NOBUF
+          break;
+        case JSS_NAMES:
+        case JSS_FXDATA:
+          done = appendModes(*_stage == JSS_FXDATA);
+          break;
+        case JSS_PALETTES: {
+          size_t len = strlen_P(JSON_palette_names) - _index;
+          if (len > JSON_STREAM_PART) { len = JSON_STREAM_PART; done = false; }
+          if (reserve(len)) {
+            memcpy_P(_buf, JSON_palette_names + _index, len);
+            _len = len;
+          }
+          _index += len;
+          } break;
+      }
+      if (done) {
+        _stage++;
+        _index = 0;
+        _items = 0;
+      }
+    }
+    return true;
+  }
+
+  public:
+  // chunked transfer for HTTP/1.1, HTTP/1.0 clients receive data until the connection is closed
+  JsonStreamResponse(const uint8_t *stages, bool chunked)
+  : _stage(stages), _index(0), _items(0), _size(2*JSON_STREAM_PART), _len(0), _pos(0) {
+    _code = 200;
+    _contentType = FPSTR(CONTENT_TYPE_JSON);
+    _contentLength = 0;
+    _sendContentLength = false;
+    _chunked = chunked;
+    _buf = (char*)malloc(_size);
+  }
+
+  virtual ~JsonStreamResponse() { free(_buf); }
+
+  bool _sourceValid() const { return _buf != nullptr; }
+
+  virtual size_t _fillBuffer(uint8_t *data, size_t len) {
+    size_t written = 0;
+    while (written < len) {
+      if (_pos >= _len && !nextPart()) break;
+      size_t n = std::min(len - written, _len - _pos);
+      memcpy(data + written, _buf + _pos, n);
+      written += n;
+      _pos += n;
+    }
+    return written;
+  }
 };
 
 void serveJson(AsyncWebServerRequest* request)
@@ -1033,6 +1341,7 @@ void serveJson(AsyncWebServerRequest* request)
   else if (url.indexOf(F("palx"))  > 0) subJson = JSON_PATH_PALETTES;
   else if (url.indexOf(F("fxda"))  > 0) subJson = JSON_PATH_FXDATA;
   else if (url.indexOf(F("net"))   > 0) subJson = JSON_PATH_NETWORKS;
+  else if (url.indexOf(F("perf"))  > 0) subJson = JSON_PATH_PERF;
   #ifdef WLED_ENABLE_JSONLIVE
   else if (url.indexOf("live")     > 0) {
     serveLiveLeds(request);
@@ -1051,16 +1360,43 @@ void serveJson(AsyncWebServerRequest* request)
     return;
   }
 
-  if (!requestJSONBufferLock(17)) {
+  const uint8_t *stages = nullptr;
+  switch (subJson) {
+    case JSON_PATH_STATE:      stages = jsonStreamState;     break;
+    case JSON_PATH_INFO:       stages = jsonStreamInfo;      break;
+    case JSON_PATH_STATE_INFO: stages = jsonStreamStateInfo; break;
+    case JSON_PATH_EFFECTS:    stages = jsonStreamEffects;   break;
+    case JSON_PATH_FXDATA:     stages = jsonStreamFxData;    break;
+    case 0:                    stages = jsonStreamAll;       break;
+  }
+  if (stages) {
+    JsonStreamResponse *response = new JsonStreamResponse(stages, request->version() > 0);
+    if (response && response->_sourceValid()) {
+      request->send(response);
+      return;
+    }
+    delete response; // not enough heap for part buffer, use JSON document
+  }
+
+  size_t docSize = JSON_BUFFER_SIZE; // state/info/effects if streaming is not possible
+  switch (subJson) {
+    case JSON_PATH_NODES:
+    case JSON_PATH_NETWORKS:
+    case JSON_PATH_PERF:     docSize = JSON_DOC_SERVE_SMALL;   break;
+    case JSON_PATH_PALETTES: docSize = JSON_BUFFER_SIZE / 2;   break; // a page of palettes
+  }
+  JsonDocument *doc = requestJSONDoc(17, JSON_DOC_SERVE, docSize);
+  if (!doc) {
     serveJsonError(request, 503, ERR_NOBUF);
     return;
   }
-  // releaseJSONBufferLock() will be called when "response" is destroyed (from AsyncWebServer)
+  // releaseJSONDoc() will be called when "response" is destroyed (from AsyncWebServer)
   // make sure you delete "response" if no "request->send(response);" is made
-  LockedJsonResponse *response = new LockedJsonResponse(pDoc, subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS); // will clear and convert JsonDocument into JsonArray if necessary
+  LockedJsonResponse *response = new LockedJsonResponse(doc, subJson==JSON_PATH_FXDATA || subJson==JSON_PATH_EFFECTS); // will clear and convert JsonDocument into JsonArray if necessary
 
   JsonVariant lDoc = response->getRoot();
 
+  StateLock stateLock; // segments must not change while being serialized (response document does not lock pDoc)
   switch (subJson)
   {
     case JSON_PATH_STATE:
@@ -1077,6 +1413,10 @@ void serveJson(AsyncWebServerRequest* request)
       serializeModeData(lDoc); break;
     case JSON_PATH_NETWORKS:
       serializeNetworks(lDoc); break;
+    case JSON_PATH_PERF:
+      PerfMonitor::serialize(lDoc);
+      if (request->hasParam(F("reset"))) PerfMonitor::reset(); // read & clear
+      break;
     default: //all
       JsonObject state = lDoc.createNestedObject("state");
       serializeState(state);
@@ -0,0 +1,76 @@
+#include "wled.h"
+
+/*
+ * Frame timing statistics
+ */
+
+PerfStat PerfMonitor::effect[MAX_NUM_SEGMENTS];
+PerfStat PerfMonitor::blend;
+PerfStat PerfMonitor::busFill;
+PerfStat PerfMonitor::show;
+PerfStat PerfMonitor::outWait;
+PerfStat PerfMonitor::usermod[WLED_MAX_USERMODS];
+unsigned long PerfMonitor::since = 0;
+
+void PerfMonitor::reset() {
+  for (auto &stat : effect)  stat.reset();
+  for (auto &stat : usermod) stat.reset();
+  blend.reset();
+  busFill.reset();
+  show.reset();
+  outWait.reset();
+  since = millis();
+}
+
+// [min, avg, max, count] or empty array if nothing was measured
+static void serializePerfStat(JsonArray arr, const PerfStat &stat) {
+  if (!stat.count) return;
+  arr.add(stat.min);
+  arr.add(stat.avg());
+  arr.add(stat.max);
+  arr.add(stat.count);
+}
+
+void PerfMonitor::serialize(JsonObject root, bool full) {
+  root[F("age")] = (millis() - since) / 1000; // seconds since last reset
+  serializePerfStat(root.createNestedArray(F("blend")), blend);
+  serializePerfStat(root.createNestedArray(F("fill")),  busFill);
+  serializePerfStat(root.createNestedArray(F("show")),  show);
+  if (outWait.count) serializePerfStat(root.createNestedArray(F("wait")), outWait); // only with output task
+  // frame budget scheduler
+  root[F("budget")] = strip.getFrameBudget();
+  root[F("load")]   = strip.getFrameLoad();
+
+  if (!full) {
+    // only report the most expensive segment and number of throttled segments
+    unsigned worst = 0;
+    unsigned throttled = 0;
+    for (unsigned i = 0; i < strip.getSegmentsNum(); i++) {
+      if (effect[i].avg() > effect[worst].avg()) worst = i;
+      if (strip.getSegment(i).throttle) throttled++;
+    }
+    root[F("wseg")] = worst;
+    root[F("thr")]  = throttled;
+    serializePerfStat(root.createNestedArray("fx"), effect[worst]);
+    return;
+  }
+
+  JsonArray segs = root.createNestedArray("seg");
+  for (unsigned i = 0; i < strip.getSegmentsNum(); i++) {
+    const Segment &seg = strip.getSegment(i);
+    if (!seg.isActive() || !effect[i].count) continue;
+    JsonObject s = segs.createNestedObject();
+    s["id"] = i;
+    s["fx"] = seg.mode;
+    serializePerfStat(s.createNestedArray("t"), effect[i]);
+    s[F("cost")] = seg.cost;     // moving average used by scheduler
+    s[F("thr")]  = seg.throttle; // frames skipped between updates
+  }
+
+  JsonArray mods = root.createNestedArray("um");
+  for (unsigned i = 0; i < UsermodManager::getModCount(); i++) {
+    JsonObject m = mods.createNestedObject();
+    m["id"] = UsermodManager::getModId(i);
+    serializePerfStat(m.createNestedArray("t"), usermod[i]);
+  }
+}
@@ -0,0 +1,42 @@
+#ifndef WLED_PERF_H
+#define WLED_PERF_H
+/*
+ * Always-on frame timing statistics (effects, blending, bus fill, show, usermods)
+ * All times are in microseconds. Exposed in /json/info ("perf") and /json/perf (reset with /json/perf?reset).
+ */
+
+// min/avg/max accumulator for a single measured section
+class PerfStat {
+  public:
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+
+    PerfStat() { reset(); }
+
+    inline void reset() { count = 0; min = UINT32_MAX; max = 0; total = 0; }
+    inline void add(uint32_t us) {
+      count++;
+      total += us;
+      if (us < min) min = us;
+      if (us > max) max = us;
+    }
+    inline uint32_t avg() const { return count ? total / count : 0; }
+};
+
+class PerfMonitor {
+  public:
+    static PerfStat effect[MAX_NUM_SEGMENTS];   // effect function per segment (index as in strip.getSegment())
+    static PerfStat blend;                      // old effect during transitions and compositing of segment layers
+    static PerfStat busFill;                    // writing composited pixels to buses
+    static PerfStat show;                       // BusManager::show() (handover only if output task is used)
+    static PerfStat outWait;                    // per frame wait for output task (near 0 if rendering overlaps sending)
+    static PerfStat usermod[WLED_MAX_USERMODS]; // Usermod::loop() (index as registered)
+    static unsigned long since;                 // millis() of last reset
+
+    static void reset();
+    static void serialize(JsonObject root, bool full = true); // full includes per segment and per usermod statistics
+};
+
+#endif
@@ -69,7 +69,10 @@ static void doSaveState() {
   #endif
   writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
 
-  if (persist) presetsModifiedTime = toki.second(); //unix time
+  if (persist) {
+    presetsModifiedTime = toki.second(); //unix time
+    invalidatePresetCache();
+  }
   releaseJSONBufferLock();
   updateFSInfo();
 
@@ -141,6 +144,323 @@ void applyPresetWithFallback(uint8_t index, uint8_t callMode, uint8_t effectID,
   effectPalette = paletteID;
 }
 
+/*
+ * Preset cache: presets that only set state (on, bri, transition, segments) are kept as validated binary
+ * snapshots (LRU) so applying them again needs neither the file system nor JSON parsing (and no JSON buffer lock).
+ * Presets containing API calls, playlists, relative/random/toggle values, individual LEDs or unknown keys
+ * are not cached and always go through deserializeState(). Unknown keys include all usermod keys, so
+ * UsermodManager::readFromJsonState() has nothing to read from a cached preset and is not called for it.
+ * Segment properties are applied by applySegmentFields() (json.cpp), same as for JSON API requests.
+ */
+#ifndef WLED_PRESET_CACHE_SIZE
+  #ifdef ESP8266
+  #define WLED_PRESET_CACHE_SIZE 4
+  #else
+  #define WLED_PRESET_CACHE_SIZE 8
+  #endif
+#endif
+#ifndef WLED_PRESET_CACHE_BYTES
+  #ifdef ESP8266
+  #define WLED_PRESET_CACHE_BYTES 1024 // max memory held by all snapshots
+  #else
+  #define WLED_PRESET_CACHE_BYTES 4096
+  #endif
+#endif
+
+// cacheable root and segment keys, bit position in has mask is the index in the list (segment keys in SF_* order)
+static const char pcRootKeys[] PROGMEM = "on,bri,transition,bs,mainseg,seg,n,ql";
+static const char pcSegKeys[]  PROGMEM = "id,start,stop,startY,stopY,len,grp,spc,of,n,on,frz,bri,bm,cct,set,col,fx,sx,ix,pal,c1,c2,c3,sel,rev,mi,rY,mY,tp,o1,o2,o3,si,m12";
+enum { PCR_ON, PCR_BRI, PCR_TR, PCR_BS, PCR_MAINSEG, PCR_SEG };
+#define PC_SEG_NEXT 255 // entry in snapshot order list: apply next segment (other entries are ids of segments to delete)
+
+typedef struct PresetSnapshot {
+  std::vector<segfields_t> segs;  // segments with properties
+  std::vector<uint8_t> order;     // order segments are applied in, empty segments ({"stop":0}) are stored as their id only
+  uint32_t lastUsed;              // LRU tick
+  uint16_t bytes = 0;             // memory used by snapshot
+  uint16_t transition;            // in 100ms
+  uint8_t  id = 0;                // preset ID, 0 if slot is empty
+  uint8_t  has;                   // PCR_* keys present in preset
+  uint8_t  bri, bs, mainseg;
+  bool     on;
+} preset_snapshot_t;
+
+static preset_snapshot_t presetCache[WLED_PRESET_CACHE_SIZE];
+static uint32_t      presetCacheTick = 0;
+static size_t        presetCacheBytes = 0;    // memory held by all cached snapshots
+static unsigned long presetCacheModified = 0; // presetsModifiedTime, cacheInvalidate, LED count and palettes cache was filled with
+static byte          presetCacheValidate = 0;
+static uint16_t      presetCacheLength = 0;
+static uint8_t       presetCachePalettes = 0;
+
+// returns index of key in comma separated PROGMEM list or -1
+static int findKey_P(const char *key, const char *list) {
+  const size_t len = strlen(key);
+  for (int idx = 0; ; idx++) {
+    const char *e = strchr_P(list, ',');
+    const size_t l = e ? size_t(e - list) : strlen_P(list);
+    if (l == len && strncmp_P(key, list, len) == 0) return idx;
+    if (!e) return -1;
+    list = e + 1;
+  }
+}
+
+// integer JSON value within range (strings are relative or random values and cannot be cached)
+static bool pcGetInt(JsonVariant v, long vmin, long vmax, long &out) {
+  if (!v.is<long>()) return false;
+  out = v.as<long>();
+  return out >= vmin && out <= vmax;
+}
+
+static void freePresetSnapshot(preset_snapshot_t &snap) {
+  for (auto &s : snap.segs) delete[] s.name;
+  snap.segs.clear();
+  snap.segs.shrink_to_fit();
+  snap.order.clear();
+  snap.order.shrink_to_fit();
+  if (snap.id) presetCacheBytes -= snap.bytes;
+  snap.bytes = 0;
+  snap.id = 0;
+}
+
+void invalidatePresetCache() {
+  for (auto &snap : presetCache) if (snap.id) freePresetSnapshot(snap);
+  presetCacheModified = presetsModifiedTime;
+  presetCacheValidate = cacheInvalidate;
+  presetCacheLength   = strip.getLengthTotal();
+  presetCachePalettes = strip.getPaletteCount();
+}
+
+// cached presets are dropped if presets were modified (also by upload) or LED setup/custom palettes changed
+static void checkPresetCache() {
+  if (presetCacheModified != presetsModifiedTime || presetCacheValidate != cacheInvalidate ||
+      presetCacheLength != strip.getLengthTotal() || presetCachePalettes != strip.getPaletteCount()) invalidatePresetCache();
+}
+
+static bool parsePresetSegment(JsonObject elem, segfields_t &ps) {
+  long v;
+  for (JsonPair kv : elem) {
+    const int key = findKey_P(kv.key().c_str(), pcSegKeys);
+    JsonVariant val = kv.value();
+    switch (key) {
+      case SF_ID:     if (!pcGetInt(val, 0, 255, v))    return false; ps.id = v;     break;
+      case SF_START:  if (!pcGetInt(val, 0, 65535, v))  return false; ps.start = v;  break;
+      case SF_STOP:   if (!pcGetInt(val, 0, 65535, v))  return false; ps.stop = v;   break;
+      case SF_STARTY: if (!pcGetInt(val, 0, 255, v))    return false; ps.startY = v; break;
+      case SF_STOPY:  if (!pcGetInt(val, 0, 255, v))    return false; ps.stopY = v;  break;
+      case SF_LEN:    if (!pcGetInt(val, 0, 65535, v))  return false; ps.len = v;    break;
+      case SF_GRP:    if (!pcGetInt(val, 0, 255, v))    return false; ps.grp = v;    break;
+      case SF_SPC:    if (!pcGetInt(val, 0, 255, v))    return false; ps.spc = v;    break;
+      case SF_OF:     if (!pcGetInt(val, INT16_MIN, INT16_MAX, v)) return false; ps.offset = v; break;
+      case SF_BRI:    if (!pcGetInt(val, 0, 255, v))    return false; ps.bri = v;    break;
+      case SF_BM:     if (!pcGetInt(val, 0, 255, v))    return false; ps.bm = v;     break;
+      case SF_CCT:    if (!pcGetInt(val, 0, 255, v))    return false; ps.cct = v;    break;
+      case SF_SET:    if (!pcGetInt(val, 0, 255, v))    return false; ps.set = v;    break;
+      case SF_FX:     if (!pcGetInt(val, 0, 255, v))    return false; ps.fx = v;     break;
+      case SF_SX:     if (!pcGetInt(val, 0, 255, v))    return false; ps.sx = v;     break;
+      case SF_IX:     if (!pcGetInt(val, 0, 255, v))    return false; ps.ix = v;     break;
+      case SF_PAL:    if (!pcGetInt(val, 0, 255, v))    return false; ps.pal = v;    break;
+      case SF_C1:     if (!pcGetInt(val, 0, 255, v))    return false; ps.c1 = v;     break;
+      case SF_C2:     if (!pcGetInt(val, 0, 255, v))    return false; ps.c2 = v;     break;
+      case SF_C3:     if (!pcGetInt(val, 0, 255, v))    return false; ps.c3 = v;     break;
+      case SF_SI:     if (!pcGetInt(val, 0, 255, v))    return false; ps.si = v;     break;
+      case SF_M12:    if (!pcGetInt(val, 0, 255, v))    return false; ps.m12 = v;    break;
+      case SF_ON: case SF_FRZ: case SF_SEL: case SF_REV: case SF_MI: case SF_RY: case SF_MY: case SF_TP: case SF_O1: case SF_O2: case SF_O3: {
+        if (!val.is<bool>()) return false; // "t" toggles
+        bool b = val.as<bool>();
+        switch (key) {
+          case SF_ON:  ps.on  = b; break;
+          case SF_FRZ: ps.frz = b; break;
+          case SF_SEL: ps.sel = b; break;
+          case SF_REV: ps.rev = b; break;
+          case SF_MI:  ps.mi  = b; break;
+          case SF_RY:  ps.rY  = b; break;
+          case SF_MY:  ps.mY  = b; break;
+          case SF_TP:  ps.tp  = b; break;
+          case SF_O1:  ps.o1  = b; break;
+          case SF_O2:  ps.o2  = b; break;
+          default:     ps.o3  = b; break;
+        }
+        break;
+      }
+      case SF_N: {
+        if (!val.is<const char*>()) return false;
+        const char *name = val.as<const char*>();
+        size_t len = strnlen(name, WLED_MAX_SEGNAME_LEN);
+        if (len) {
+          char *copy = new char[len+1];
+          if (!copy) return false;
+          strlcpy(copy, name, len+1);
+          ps.name = copy;
+        }
+        break;
+      }
+      case SF_COL: {
+        // same rules as deserializeSegment(), colors are converted to RGBW once
+        JsonArray colarr = val;
+        if (colarr.isNull()) return false;
+        for (size_t i = 0; i < NUM_COLORS; i++) {
+          JsonVariant c = colarr[i];
+          byte brgbw[] = {0,0,0,0};
+          if (c.is<JsonArray>()) {
+            if (c.size() == 0) continue;
+            int rgbw[] = {0,0,0,0};
+            copyArray(c.as<JsonArray>(), rgbw, 4);
+            ps.colors[i] = RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
+          } else if (c.is<JsonObject>()) {
+            return false; // individual channels depend on current color
+          } else if (c.is<const char*>()) {
+            if (!colorFromHexString(brgbw, c.as<const char*>())) continue;
+            ps.colors[i] = RGBW32(brgbw[0],brgbw[1],brgbw[2],brgbw[3]);
+          } else {
+            int kelvin = c | -1;
+            if (kelvin < 0) continue;
+            if (kelvin > 0) colorKtoRGB(kelvin, brgbw);
+            ps.colors[i] = RGBW32(brgbw[0],brgbw[1],brgbw[2],brgbw[3]);
+          }
+          ps.colSet |= 1 << i;
+        }
+        break;
+      }
+      default: return false; // "rpt", "i", "fxdef", "lx", usermod keys, ...
+    }
+    SF_SET(ps, key);
+  }
+  return true;
+}
+
+// adds segment to snapshot, empty segments ({"stop":0} placeholders written for unused segment slots) only store their id
+static bool addPresetSegment(JsonVariant elem, byte it, preset_snapshot_t &snap) {
+  if (!elem.is<JsonObject>()) return false;
+  segfields_t ps = {};
+  ps.id = it;
+  const bool ok = parsePresetSegment(elem, ps);
+  if (ok && SF_HAS(ps, SF_STOP) && ps.stop == 0 && (ps.has & ~((uint64_t(1) << SF_ID) | (uint64_t(1) << SF_STOP))) == 0) {
+    if (ps.id != PC_SEG_NEXT) snap.order.push_back(ps.id); // id 255 is never a valid segment
+    return true;
+  }
+  snap.segs.push_back(ps); // also if parsing failed, so name is freed with snapshot
+  snap.order.push_back(PC_SEG_NEXT);
+  return ok;
+}
+
+// fills snapshot from preset JSON (must be called before deserializeState() modifies it), returns false if preset cannot be cached
+static bool parsePresetSnapshot(JsonObject root, preset_snapshot_t &snap) {
+  long v;
+  snap.has = 0;
+  for (JsonPair kv : root) {
+    const int key = findKey_P(kv.key().c_str(), pcRootKeys);
+    JsonVariant val = kv.value();
+    switch (key) {
+      case PCR_ON:      if (!val.is<bool>()) return false; snap.on = val; break;
+      case PCR_BRI:     if (!pcGetInt(val, 0, 255, v)) return false; snap.bri = v; break;
+      case PCR_TR:      if (!pcGetInt(val, 0, 655, v)) return false; snap.transition = v; break;
+      case PCR_BS:      if (!pcGetInt(val, 0, 255, v)) return false; snap.bs = v; break;
+      case PCR_MAINSEG: if (!pcGetInt(val, 0, 255, v)) return false; snap.mainseg = v; break;
+      case PCR_SEG:
+        if (val.is<JsonObject>()) {
+          if (val["id"].isNull()) return false; // applies to selected segments
+          if (!addPresetSegment(val, 0, snap)) return false;
+        } else if (val.is<JsonArray>()) {
+          byte it = 0;
+          for (JsonVariant elem : val.as<JsonArray>()) if (!addPresetSegment(elem, it++, snap)) return false;
+        } else return false;
+        break;
+      case 6: case 7: continue; // name and quick load label
+      default: return false;    // API calls, playlists, usermod keys, ...
+    }
+    snap.has |= 1 << key;
+  }
+  snap.segs.shrink_to_fit();
+  snap.order.shrink_to_fit();
+  size_t bytes = snap.segs.size() * sizeof(segfields_t) + snap.order.size();
+  for (const auto &s : snap.segs) if (s.name) bytes += strlen(s.name) + 1;
+  snap.bytes = min(bytes, size_t(UINT16_MAX));
+  // same condition as changePreset in handlePresets()
+  return snap.has & ((1 << PCR_SEG) | (1 << PCR_ON) | (1 << PCR_BRI));
+}
+
+// applies one segment of a snapshot the same way deserializeSegment() applies JSON, returns false if segment was deleted
+static bool applyPresetSegment(const segfields_t &ps) {
+  bool newSeg;
+  int id = prepareSegmentUpdate(ps.id, SF_HAS(ps, SF_STOP) ? ps.stop : -1, newSeg);
+  if (id < 0) return true;
+  if (!applySegmentFields(strip.getSegment(id), id, newSeg, ps)) return false;
+  stateChanged = true; // preset is expected to change segment (avoids comparing with a copy of the segment)
+  return true;
+}
+
+// applies snapshot the same way deserializeState() applies preset JSON
+static void applyPresetSnapshot(const preset_snapshot_t &snap) {
+  StateLock stateLock; // async web server task may be serializing segments
+  bool onBefore = bri;
+  if (snap.has & (1 << PCR_BRI)) bri = snap.bri;
+  bool on = (snap.has & (1 << PCR_ON)) ? snap.on : (bri > 0);
+  if (!on != !bri) toggleOnOff();
+
+  if (bri && !onBefore) { // unfreeze all segments when turning on
+    for (size_t s=0; s < strip.getSegmentsNum(); s++) strip.getSegment(s).freeze = false;
+    if (realtimeMode && !realtimeOverride && useMainSegmentOnly) strip.getMainSegment().freeze = true; // keep live segment frozen if live
+  }
+
+  if ((snap.has & (1 << PCR_TR)) && currentPlaylist < 0) { // do not apply transition time from preset if playlist active
+    transitionDelay = snap.transition * 100;
+    if (fadeTransition) strip.setTransition(transitionDelay);
+  }
+  #ifndef WLED_DISABLE_MODE_BLEND
+  if (snap.has & (1 << PCR_BS)) blendingStyle = snap.bs < BLEND_STYLE_COUNT ? snap.bs : BLEND_STYLE_FADE;
+  #endif
+  if ((snap.has & (1 << PCR_MAINSEG)) && !realtimeMode) strip.setMainSegmentId(snap.mainseg);
+  if (realtimeMode && useMainSegmentOnly) strip.getMainSegment().freeze = !realtimeOverride;
+
+  if (snap.has & (1 << PCR_SEG)) {
+    strip.suspend();
+    size_t deleted = 0;
+    auto seg = snap.segs.begin();
+    for (uint8_t entry : snap.order) {
+      if (entry == PC_SEG_NEXT) {
+        if (seg == snap.segs.end()) break;
+        if (!applyPresetSegment(*seg++)) deleted++;
+      } else {
+        segfields_t empty = {}; // {"id":entry,"stop":0}
+        empty.id = entry;
+        SF_SET(empty, SF_ID);
+        SF_SET(empty, SF_STOP);
+        if (!applyPresetSegment(empty)) deleted++;
+      }
+    }
+    if (strip.getSegmentsNum() > 3 && deleted >= strip.getSegmentsNum()/2U) strip.purgeSegments(); // batch deleting more than half segments
+  }
+  strip.resume();
+  stateUpdated(CALL_MODE_NO_NOTIFY);
+}
+
+// stores snapshot in least recently used slot, evicts further snapshots if memory budget is exceeded
+static void storePresetSnapshot(byte index, preset_snapshot_t &snap) {
+  if (snap.bytes > WLED_PRESET_CACHE_BYTES) { freePresetSnapshot(snap); return; } // too large to be cached
+  preset_snapshot_t *slot;
+  for (;;) {
+    preset_snapshot_t *lru = nullptr;
+    slot = nullptr;
+    for (auto &s : presetCache) {
+      if (!s.id) { if (!slot) slot = &s; }
+      else if (!lru || s.lastUsed < lru->lastUsed) lru = &s;
+    }
+    if (slot && presetCacheBytes + snap.bytes <= WLED_PRESET_CACHE_BYTES) break;
+    freePresetSnapshot(*lru); // there is a cached snapshot if cache is full or budget is exceeded
+  }
+  std::swap(*slot, snap);
+  slot->id = index;
+  slot->lastUsed = ++presetCacheTick;
+  presetCacheBytes += slot->bytes;
+}
+
+static preset_snapshot_t *findPresetSnapshot(byte index) {
+  checkPresetCache();
+  for (auto &s : presetCache) if (s.id == index) return &s;
+  return nullptr;
+}
+
 void handlePresets()
 {
   byte presetErrFlag = ERR_NONE;
@@ -151,13 +471,36 @@ void handlePresets()
     return;
   }
 
-  if (presetToApply == 0 || !requestJSONBufferLock(9)) return; // no preset waiting to apply, or JSON buffer is already allocated, return to loop until free
+  if (presetToApply == 0) {
+    handlePresetsCompaction(); // reclaim space left by replaced/deleted presets while idle
+    return;
+  }
+
+  preset_snapshot_t *cached = findPresetSnapshot(presetToApply);
+  if (cached) {
+    byte tmpMode = callModeToApply;
+    DEBUG_PRINTF_P(PSTR("Applying cached preset: %u\n"), (unsigned)presetToApply);
+    cached->lastUsed = ++presetCacheTick;
+    presetToApply = 0;
+    callModeToApply = 0;
+    applyPresetSnapshot(*cached);
+    if (errorFlag == ERR_FS_PLOAD) errorFlag = ERR_NONE;
+    if (!errorFlag) currentPreset = cached->id;
+    notify(tmpMode);
+    stateUpdated(tmpMode);
+    updateInterfaces(tmpMode);
+    return;
+  }
+
+  if (!requestJSONBufferLock(9)) return; // JSON buffer is already allocated, return to loop until free
 
   bool changePreset = false;
   uint8_t tmpPreset = presetToApply; // store temporary since deserializeState() may call applyPreset()
   uint8_t tmpMode   = callModeToApply;
 
   JsonObject fdo;
+  preset_snapshot_t snap;
+  bool cacheable = false;
 
   presetToApply = 0; //clear request for preset
   callModeToApply = 0;
@@ -193,11 +536,14 @@ void handlePresets()
     changePreset = true;
   } else {
     if (!fdo["seg"].isNull() || !fdo["on"].isNull() || !fdo["bri"].isNull() || !fdo["nl"].isNull() || !fdo["ps"].isNull() || !fdo[F("playlist")].isNull()) changePreset = true;
+    cacheable = tmpPreset < 255 && presetErrFlag == ERR_NONE && parsePresetSnapshot(fdo, snap);
     if (!(tmpMode == CALL_MODE_BUTTON_PRESET && fdo["ps"].is<const char *>() && strchr(fdo["ps"].as<const char *>(),'~') != strrchr(fdo["ps"].as<const char *>(),'~')))
       fdo.remove("ps"); // remove load request for presets to prevent recursive crash (if not called by button and contains preset cycling string "1~5~")
     deserializeState(fdo, CALL_MODE_NO_NOTIFY, tmpPreset); // may change presetToApply by calling applyPreset()
   }
   if (!errorFlag && tmpPreset < 255 && changePreset) currentPreset = tmpPreset;
+  if (cacheable && !errorFlag) storePresetSnapshot(tmpPreset, snap);
+  else freePresetSnapshot(snap);
 
   #if defined(ARDUINO_ARCH_ESP32)
   //Aircoookie recommended not to delete buffer
@@ -261,6 +607,7 @@ void savePreset(byte index, const char* pname, JsonObject sObj)
         initPresetsFile(); // just in case if someone deleted presets.json using /edit
         writeObjectToFileUsingId(getPresetsFileName(), index, pDoc);
         presetsModifiedTime = toki.second(); //unix time
+        invalidatePresetCache();
         updateFSInfo();
       }
       delete[] saveName;
@@ -280,5 +627,6 @@ void deletePreset(byte index) {
   StaticJsonDocument<24> empty;
   writeObjectToFileUsingId(getPresetsFileName(), index, &empty);
   presetsModifiedTime = toki.second(); //unix time
+  invalidatePresetCache();
   updateFSInfo();
 }
\ No newline at end of file
@@ -139,6 +139,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     Bus::setGlobalAWMode(request->arg(F("AW")).toInt());
     strip.setTargetFps(request->arg(F("FR")).toInt());
     useGlobalLedBuffer = request->hasArg(F("LD"));
+    useSegmentBuffers = request->hasArg(F("SB"));
 
     bool busesChanged = false;
     for (int s = 0; s < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; s++) {
@@ -156,6 +157,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       char sp[4] = "SP"; sp[2] = offset+s; sp[3] = 0; //bus clock speed (DotStar & PWM)
       char la[4] = "LA"; la[2] = offset+s; la[3] = 0; //LED mA
       char ma[4] = "MA"; ma[2] = offset+s; ma[3] = 0; //max mA
+      char no[4] = "NO"; no[2] = offset+s; no[3] = 0; //network start universe/channel
+      char nd[4] = "ND"; nd[2] = offset+s; nd[3] = 0; //network additional receivers
       if (!request->hasArg(lp)) {
         DEBUG_PRINTF_P(PSTR("No data for %d\n"), s);
         break;
@@ -194,6 +197,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
           case 3 : freq = 10000; break;
           case 4 : freq = 20000; break;
         }
+      } else if (Bus::isVirtual(type)) {
+        freq = request->arg(no).toInt(); // start universe/channel
       } else {
         freq = 0;
       }
@@ -210,6 +215,20 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       // this may happen even before this loop is finished so we do "doInitBusses" after the loop
       if (busConfigs[s] != nullptr) delete busConfigs[s];
       busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder | (channelSwap<<4), request->hasArg(cv), skip, awmode, freq, useGlobalLedBuffer, maPerLed, maMax);
+      if (Bus::isVirtual(type) && request->hasArg(nd)) {
+        // comma separated list of additional receivers
+        String dests = request->arg(nd);
+        int pos = 0;
+        while (pos < (int)dests.length()) {
+          int end = dests.indexOf(',', pos);
+          if (end < 0) end = dests.length();
+          String dest = dests.substring(pos, end);
+          dest.trim();
+          IPAddress ip;
+          if (dest.length() && ip.fromString(dest)) busConfigs[s]->addDestination(ip);
+          pos = end + 1;
+        }
+      }
       busesChanged = true;
     }
     //doInitBusses = busesChanged; // we will do that below to ensure all input data is processed
@@ -328,6 +347,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 
     fadeTransition = request->hasArg(F("TF"));
     modeBlending = request->hasArg(F("EB"));
+    t = request->arg(F("BS")).toInt();
+    if (t >= 0 && t < BLEND_STYLE_COUNT) blendingStyle = t;
     t = request->arg(F("TD")).toInt();
     if (t >= 0) transitionDelayDefault = t;
     strip.paletteFade = request->hasArg(F("PF"));
@@ -58,11 +58,13 @@ typedef struct ip_addr ip4_addr_t;
 
 #define ARTNET_OPCODE_OPDMX 0x5000
 #define ARTNET_OPCODE_OPPOLL 0x2000
+#define ARTNET_OPCODE_OPSYNC 0x5200
 #define ARTNET_OPCODE_OPPOLLREPLY 0x2100
 
 #define P_E131   0
 #define P_ARTNET 1
 #define P_DDP    2
+#define P_E131_SYNC 3
 
 // E1.31 Packet Offsets
 #define E131_ROOT_PREAMBLE_SIZE 0
@@ -76,7 +78,7 @@ typedef struct ip_addr ip4_addr_t;
 #define E131_FRAME_VECTOR 40
 #define E131_FRAME_SOURCE 44
 #define E131_FRAME_PRIORITY 108
-#define E131_FRAME_RESERVED 109
+#define E131_FRAME_SYNC_ADDR 109
 #define E131_FRAME_SEQ 111
 #define E131_FRAME_OPT 112
 #define E131_FRAME_UNIVERSE 113
@@ -89,6 +91,10 @@ typedef struct ip_addr ip4_addr_t;
 #define E131_DMP_COUNT 123
 #define E131_DMP_DATA 125
 
+// E1.31 Synchronization Packet Offsets (root layer is identical)
+#define E131_SYNC_SEQ 44
+#define E131_SYNC_ADDR 45
+
 // E1.31 Packet Structure
 typedef union {
     struct { //E1.31 packet
@@ -105,7 +111,7 @@ typedef union {
       uint32_t frame_vector;
       uint8_t  source_name[64];
       uint8_t  priority;
-      uint16_t reserved;
+      uint16_t sync_address; // E1.31-2016 synchronization universe (0 = unsynchronized)
       uint8_t  sequence_number;
       uint8_t  options;
       uint16_t universe;
@@ -207,7 +213,9 @@ class ESPAsyncE131 {
     static const uint8_t ACN_ID[];
 	  static const uint8_t ART_ID[];
     static const uint32_t VECTOR_ROOT = 4;
+    static const uint32_t VECTOR_ROOT_EXTENDED = 8;
     static const uint32_t VECTOR_FRAME = 2;
+    static const uint32_t VECTOR_FRAME_SYNC = 1;
     static const uint8_t VECTOR_DMP = 2;
 
     AsyncUDP        udp;        // AsyncUDP
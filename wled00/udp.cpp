@@ -428,7 +428,14 @@ void realtimeLock(uint32_t timeoutMs, byte md)
       stop  = strip.getLengthTotal();
     }
     // clear strip/segment
+    SegmentBufferLock lock;
+    BusManager::waitForOutput(); // previous frame must be sent before bus buffers are written
     for (size_t i = start; i < stop; i++) strip.setPixelColor(i,BLACK);
+    if (useMainSegmentOnly && strip.getMainSegment().pixels) {
+      // buffered main segment is composited over the strip, clear its last effect frame too
+      strip.getMainSegment().beginDraw();
+      strip.getMainSegment().fill(BLACK);
+    }
   }
   // if strip is off (bri==0) and not already in RTM
   if (briT == 0 && !realtimeMode && !realtimeOverride) {
@@ -442,7 +449,7 @@ void realtimeLock(uint32_t timeoutMs, byte md)
 
   if (realtimeOverride) return;
   if (arlsForceMaxBri) strip.setBrightness(scaledBri(255), true);
-  if (briT > 0 && md == REALTIME_MODE_GENERIC) strip.show();
+  if (briT > 0 && md == REALTIME_MODE_GENERIC) strip.showRealtime();
 }
 
 void exitRealtime() {
@@ -480,10 +487,13 @@ void handleNotifications()
     notify(notificationSentCallMode,true);
   }
 
-  if (e131NewData && millis() - strip.getLastShow() > 15)
+  // show completed realtime frames (E1.31, Art-Net, DDP) exactly once
+  handleRealtimeFrame();
+  if (e131NewData && !strip.isUpdating())
   {
     e131NewData = false;
-    strip.show();
+    realtimeFramesShown++;
+    strip.showRealtime();
   }
 
   //unlock strip when realtime UDP times out
@@ -511,12 +521,11 @@ void handleNotifications()
       rgbUdp.read(lbuf, packetSize);
       realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
       if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
-      unsigned totalLen = strip.getLengthTotal();
+      SegmentBufferLock lock; // main segment buffer must not be reallocated while writing
       if (useMainSegmentOnly) strip.getMainSegment().beginDraw(); // set up parameters for get/setPixelColor()
-      for (size_t i = 0, id = 0; i < packetSize -2 && id < totalLen; i += 3, id++) {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-      }
-      if (!(realtimeMode && useMainSegmentOnly)) strip.show();
+      else                    BusManager::waitForOutput();        // data is written to bus buffers directly
+      setRealtimePixels(0, packetSize / 3, lbuf, 3);
+      strip.showRealtime();
       return;
     }
   }
@@ -594,13 +603,15 @@ void handleNotifications()
 
     unsigned id = (tpmPayloadFrameSize/3)*(packetNum-1); //start LED
     unsigned totalLen = strip.getLengthTotal();
+    SegmentBufferLock lock; // main segment buffer must not be reallocated while writing
     if (useMainSegmentOnly) strip.getMainSegment().beginDraw(); // set up parameters for get/setPixelColor()
+    else                    BusManager::waitForOutput();        // data is written to bus buffers directly
     for (size_t i = 6; i < tpmPayloadFrameSize + 4U && id < totalLen; i += 3, id++) {
       setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
     }
     if (tpmPacketCount == numPackets) { //reset packet count and show if all packets were received
       tpmPacketCount = 0;
-      strip.show();
+      strip.showRealtime();
     }
     return;
   }
@@ -622,7 +633,9 @@ void handleNotifications()
     if (realtimeOverride && !(realtimeMode && useMainSegmentOnly)) return;
 
     unsigned totalLen = strip.getLengthTotal();
+    SegmentBufferLock lock; // main segment buffer must not be reallocated while writing
     if (useMainSegmentOnly) strip.getMainSegment().beginDraw(); // set up parameters for get/setPixelColor()
+    else                    BusManager::waitForOutput();        // data is written to bus buffers directly
     if (udpIn[0] == 1 && packetSize > 5) //warls
     {
       for (size_t i = 2; i < packetSize -3; i += 4)
@@ -631,23 +644,14 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2 && packetSize > 4) //drgb
     {
-      for (size_t i = 2, id = 0; i < packetSize -2 && id < totalLen; i += 3, id++)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-      }
+      setRealtimePixels(0, (packetSize - 2) / 3, &udpIn[2], 3);
     } else if (udpIn[0] == 3 && packetSize > 6) //drgbw
     {
-      for (size_t i = 2, id = 0; i < packetSize -3 && id < totalLen; i += 4, id++)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-      }
+      setRealtimePixels(0, (packetSize - 2) / 4, &udpIn[2], 4);
     } else if (udpIn[0] == 4 && packetSize > 7) //dnrgb
     {
       unsigned id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (size_t i = 4; i < packetSize -2 && id < totalLen; i += 3, id++)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-      }
+      setRealtimePixels(id, (packetSize - 4) / 3, &udpIn[4], 3);
     } else if (udpIn[0] == 5 && packetSize > 8) //dnrgbw
     {
       unsigned id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
@@ -656,7 +660,7 @@ void handleNotifications()
         setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
       }
     }
-    strip.show();
+    strip.showRealtime();
     return;
   }
 
@@ -697,6 +701,36 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
   }
 }
 
+// bulk version of setRealtimePixel()
+// data holds count pixels with channels (3 or 4, 4th is white) bytes each
+// pixels are converted in chunks and written to buses in runs (no per pixel bus lookup if no ledmap is in use)
+void setRealtimePixels(uint16_t i, unsigned count, const byte *data, unsigned channels)
+{
+  unsigned pix = i + arlsOffset;
+  unsigned totalLen = strip.getLengthTotal();
+  if (pix >= totalLen || !data) return;
+  if (count > totalLen - pix) count = totalLen - pix;
+  const bool gamma = !arlsDisableGammaCorrection && gammaCorrectCol;
+  constexpr unsigned chunkSize = 64;
+  uint32_t cols[chunkSize];
+  while (count > 0) {
+    unsigned n = count < chunkSize ? count : chunkSize;
+    for (unsigned k = 0; k < n; k++, data += channels) {
+      byte w = (channels > 3) ? data[3] : 0;
+      if (gamma) cols[k] = RGBW32(gamma8(data[0]), gamma8(data[1]), gamma8(data[2]), gamma8(w));
+      else       cols[k] = RGBW32(data[0], data[1], data[2], w);
+    }
+    if (useMainSegmentOnly) {
+      Segment &seg = strip.getMainSegment(); // this expects that strip.getMainSegment().beginDraw() has been called in handleNotification()
+      for (unsigned k = 0; k < n; k++) seg.setPixelColor(pix + k, cols[k]);
+    } else {
+      strip.setPixelColors(pix, cols, n);
+    }
+    pix   += n;
+    count -= n;
+  }
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
@@ -797,147 +831,175 @@ void sendSysInfoUDP()
 // 1440 channels per packet
 #define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
 
-//
-// Send real time UDP updates to the specified client
-//
-// type   - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
-// client - the IP address to send to
-// length - the number of pixels
-// buffer - a buffer of at least length*4 bytes long
-// isRGBW - true if the buffer contains 4 components per pixel
+#define E131_HEADER_LEN (E131_DMP_DATA+1) // includes DMX start code
 
 static       size_t sequenceNumber = 0; // this needs to be shared across all outputs
 static const size_t ART_NET_HEADER_SIZE = 12;
 static const byte   ART_NET_HEADER[] PROGMEM = {0x41,0x72,0x74,0x2d,0x4e,0x65,0x74,0x00,0x00,0x50,0x00,0x0e};
+#define ARTNET_HEADER_LEN (ART_NET_HEADER_SIZE+6)
+static const byte   E131_ACN_ID[] PROGMEM = {0x41,0x53,0x43,0x2d,0x45,0x31,0x2e,0x31,0x37,0x00,0x00,0x00}; // "ASC-E1.17"
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap
-
-  WiFiUDP ddpUdp;
+static WiFiUDP rtOutUdp; // shared by all network buses
+static byte    rtOutScratch[DDP_HEADER_LEN+DDP_CHANNELS_PER_PACKET]; // brightness scaled copy of a packet (largest packet is DDP)
 
+//
+// Network bus output
+// Each bus owns a buffer with all of its packets (see realtimePacketLayout()). Headers are built once by
+// realtimeInitPackets() and the bus writes pixel data directly into packet payload, so sending a frame
+// requires just one write() per packet.
+//
+// type   - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
+// isRGBW - true if the buffer contains 4 components per pixel
+//
+// returns header size and number of pixels per packet (no pixel is split across two packets)
+void realtimePacketLayout(uint8_t type, bool isRGBW, size_t &headerSize, size_t &pixelsPerPacket) {
+  const size_t channels = isRGBW ? 4 : 3;
   switch (type) {
-    case 0: // DDP
-    {
-      // calculate the number of UDP packets we need to send
-      size_t channelCount = length * (isRGBW? 4:3); // 1 channel for every R,G,B value
-      size_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
-
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer
-      size_t bufferOffset = 0;
-
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-        if (sequenceNumber > 15) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          //DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
-        // the amount of data is AFTER the header in the current packet
-        size_t packetSize = DDP_CHANNELS_PER_PACKET;
-
-        uint8_t flags = DDP_FLAGS1_VER1;
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet, set the push flag
-          // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
-          flags = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
-          if (channelCount % DDP_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
-          }
-        }
+    case 1:  headerSize = E131_HEADER_LEN;   pixelsPerPacket = 512 / channels; break; // 170 RGB or 128 RGBW LEDs per universe
+    case 2:  headerSize = ARTNET_HEADER_LEN; pixelsPerPacket = 512 / channels; break;
+    default: headerSize = DDP_HEADER_LEN;    pixelsPerPacket = DDP_CHANNELS_PER_PACKET / channels; break;
+  }
+}
 
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
+// writes static part of headers into packet buffer for length pixels
+// startOffset - first universe (E1.31, ArtNet) or first channel (DDP) used by the bus
+void realtimeInitPackets(uint8_t type, uint8_t *packets, uint16_t length, bool isRGBW, uint16_t startOffset) {
+  if (!packets || !length) return;
+  size_t headerSize, pixelsPerPacket;
+  realtimePacketLayout(type, isRGBW, headerSize, pixelsPerPacket);
+  const size_t channels     = isRGBW ? 4 : 3;
+  const size_t stride       = headerSize + pixelsPerPacket * channels;
+  const size_t channelCount = length * channels;
+  const size_t packetCount  = ((length-1) / pixelsPerPacket) + 1;
+  uint32_t channel = 0;
+
+  for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
+    uint8_t *hdr = packets + currentPacket * stride;
+    size_t packetSize = min(channelCount - channel, pixelsPerPacket * channels); // the amount of data is AFTER the header in the current packet
+    const uint32_t offset = (type == 0) ? channel + startOffset : channel; // DDP data offset
+    switch (type) {
+      case 0: // DDP
+        /*0*/hdr[0] = DDP_FLAGS1_VER1 | (currentPacket == (packetCount - 1U) ? DDP_FLAGS1_PUSH : 0); // last packet, set the push flag
+        /*1*/hdr[1] = 0; // sequence is set when sending
+        /*2*/hdr[2] = isRGBW ?  DDP_TYPE_RGBW32 : DDP_TYPE_RGB24;
+        /*3*/hdr[3] = DDP_ID_DISPLAY;
         // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
+        /*4*/hdr[4] = 0xFF & (offset >> 24);
+        /*5*/hdr[5] = 0xFF & (offset >> 16);
+        /*6*/hdr[6] = 0xFF & (offset >>  8);
+        /*7*/hdr[7] = 0xFF & (offset      );
         // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size)
-        // function is just a loop internally too
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
-
-        if (!ddpUdp.endPacket()) {
-          //DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
-
-        channel += packetSize;
-      }
-    } break;
-
-    case 1: //E1.31
-    {
-    } break;
-
-    case 2: //ArtNet
-    {
-      // calculate the number of UDP packets we need to send
-      const size_t channelCount = length * (isRGBW?4:3); // 1 channel for every R,G,B,(W?) value
-      const size_t ARTNET_CHANNELS_PER_PACKET = isRGBW?512:510; // 512/4=128 RGBW LEDs, 510/3=170 RGB LEDs
-      const size_t packetCount = ((channelCount-1)/ARTNET_CHANNELS_PER_PACKET)+1;
-
-      uint32_t channel = 0; 
-      size_t bufferOffset = 0;
-
-      sequenceNumber++;
-
-      for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-
-        if (sequenceNumber > 255) sequenceNumber = 0;
+        /*8*/hdr[8] = 0xFF & (packetSize >> 8);
+        /*9*/hdr[9] = 0xFF & (packetSize     );
+        break;
 
-        if (!ddpUdp.beginPacket(client, ARTNET_DEFAULT_PORT)) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.beginPacket returned an error"));
-          return 1; // borked
-        }
-
-        size_t packetSize = ARTNET_CHANNELS_PER_PACKET;
-
-        if (currentPacket == (packetCount - 1U)) {
-          // last packet
-          if (channelCount % ARTNET_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % ARTNET_CHANNELS_PER_PACKET;
-          }
-        }
+      case 1: // E1.31 (all values big endian, flags & length fields have 0x7 in high nibble)
+      {
+        const size_t universe = max(startOffset, (uint16_t)1) + currentPacket; // universe 0 is invalid
+        memset(hdr, 0, E131_HEADER_LEN);
+        hdr[E131_ROOT_PREAMBLE_SIZE+1] = 0x10;
+        memcpy_P(hdr + E131_ROOT_ID, E131_ACN_ID, sizeof(E131_ACN_ID));
+        hdr[E131_ROOT_FLENGTH]     = 0x70 | ((packetSize + 110) >> 8);
+        hdr[E131_ROOT_FLENGTH+1]   = 0xFF & (packetSize + 110);
+        hdr[E131_ROOT_VECTOR+3]    = 0x04; // VECTOR_ROOT_E131_DATA
+        // CID must be unique per source, derive it from MAC address
+        uint8_t mac[6];
+        WiFi.macAddress(mac);
+        for (size_t i = 0; i < 16; i++) hdr[E131_ROOT_CID+i] = mac[i % 6] ^ i;
+        hdr[E131_FRAME_FLENGTH]    = 0x70 | ((packetSize + 88) >> 8);
+        hdr[E131_FRAME_FLENGTH+1]  = 0xFF & (packetSize + 88);
+        hdr[E131_FRAME_VECTOR+3]   = 0x02; // VECTOR_E131_DATA_PACKET
+        strncpy((char*)hdr + E131_FRAME_SOURCE, serverDescription, 63);
+        hdr[E131_FRAME_PRIORITY]   = 100;
+        hdr[E131_FRAME_UNIVERSE]   = 0xFF & (universe >> 8);
+        hdr[E131_FRAME_UNIVERSE+1] = 0xFF & (universe     );
+        hdr[E131_DMP_FLENGTH]      = 0x70 | ((packetSize + 11) >> 8);
+        hdr[E131_DMP_FLENGTH+1]    = 0xFF & (packetSize + 11);
+        hdr[E131_DMP_VECTOR]       = 0x02; // VECTOR_DMP_SET_PROPERTY
+        hdr[E131_DMP_TYPE]         = 0xA1;
+        hdr[E131_DMP_ADDR_INC+1]   = 0x01;
+        hdr[E131_DMP_COUNT]        = 0xFF & ((packetSize + 1) >> 8); // includes start code
+        hdr[E131_DMP_COUNT+1]      = 0xFF & (packetSize + 1);
+      } break;
+
+      case 2: // ArtNet
+        memcpy_P(hdr, ART_NET_HEADER, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
+        hdr[ART_NET_HEADER_SIZE]   = 0;                        // sequence is set when sending
+        hdr[ART_NET_HEADER_SIZE+1] = 0x00;                     // physical - more an FYI, not really used for anything. 0..3
+        hdr[ART_NET_HEADER_SIZE+2] = 0xFF & (startOffset + currentPacket);        // Universe LSB (SubUni). 1 full packet == 1 full universe
+        hdr[ART_NET_HEADER_SIZE+3] = 0x7F & ((startOffset + currentPacket) >> 8); // Universe MSB (Net)
+        hdr[ART_NET_HEADER_SIZE+4] = 0xFF & (packetSize >> 8); // 16-bit length of channel data, MSB
+        hdr[ART_NET_HEADER_SIZE+5] = 0xFF & (packetSize     ); // 16-bit length of channel data, LSB
+        break;
+    }
+    channel += packetSize;
+  }
+}
 
-        byte header_buffer[ART_NET_HEADER_SIZE];
-        memcpy_P(header_buffer, ART_NET_HEADER, ART_NET_HEADER_SIZE);
-        ddpUdp.write(header_buffer, ART_NET_HEADER_SIZE); // This doesn't change. Hard coded ID, OpCode, and protocol version.
-        ddpUdp.write(sequenceNumber & 0xFF); // sequence number. 1..255
-        ddpUdp.write(0x00); // physical - more an FYI, not really used for anything. 0..3
-        ddpUdp.write((currentPacket) & 0xFF); // Universe LSB. 1 full packet == 1 full universe, so just use current packet number.
-        ddpUdp.write(0x00); // Universe MSB, unused.
-        ddpUdp.write(0xFF & (packetSize >> 8)); // 16-bit length of channel data, MSB
-        ddpUdp.write(0xFF & (packetSize     )); // 16-bit length of channel data, LSB
-
-        for (size_t i = 0; i < packetSize; i += (isRGBW?4:3)) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // W
-        }
+//
+// Send real time UDP updates to the specified clients
+//
+// clients    - the IP addresses to send to (each packet is prepared once and sent to all of them)
+// numClients - number of IP addresses
+// length     - the number of pixels
+// packets    - packet buffer prepared by realtimeInitPackets() with (unscaled) pixel data
+// bri        - brightness applied to the payload while sending
+uint8_t realtimeBroadcast(uint8_t type, const IPAddress *clients, size_t numClients, uint16_t length, uint8_t *packets, uint8_t bri, bool isRGBW)  {
+  if (!(apActive || interfacesInited) || !numClients || !length || !packets) return 1;  // network not initialised  031522 ajn added check for ap
+
+  size_t headerSize, pixelsPerPacket;
+  realtimePacketLayout(type, isRGBW, headerSize, pixelsPerPacket);
+  const size_t channels     = isRGBW ? 4 : 3;
+  const size_t stride       = headerSize + pixelsPerPacket * channels;
+  const size_t channelCount = length * channels;
+  const size_t packetCount  = ((length-1) / pixelsPerPacket) + 1;
+  uint16_t port = DDP_DEFAULT_PORT; // port defined in ESPAsyncE131.h
+  if (type == 1) port = E131_DEFAULT_PORT;
+  if (type == 2) port = ARTNET_DEFAULT_PORT;
+
+  if (type != 0) sequenceNumber++; // E1.31 and ArtNet use the same sequence number for all universes of a frame
+  size_t channel = 0;
+
+  for (size_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
+    uint8_t *packet = packets + currentPacket * stride;
+    const size_t packetSize = min(channelCount - channel, pixelsPerPacket * channels);
+
+    switch (type) {
+      case 0: // DDP
+        if (sequenceNumber > 15) sequenceNumber = 0;
+        packet[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+        break;
+      case 1: // E1.31
+        packet[E131_FRAME_SEQ] = sequenceNumber & 0xFF;
+        break;
+      case 2: // ArtNet
+        if (sequenceNumber > 255 || sequenceNumber == 0) sequenceNumber = 1;
+        packet[ART_NET_HEADER_SIZE] = sequenceNumber & 0xFF; // sequence number. 1..255
+        break;
+    }
 
-        if (!ddpUdp.endPacket()) {
-          DEBUG_PRINTLN(F("Art-Net WiFiUDP.endPacket returned an error"));
-          return 1; // borked
-        }
-        channel += packetSize;
+    const uint8_t *out = packet;
+    if (bri < 255) {
+      // apply brightness to the whole payload at once and send the scaled copy
+      memcpy(rtOutScratch, packet, headerSize);
+      const uint8_t *src = packet + headerSize;
+      uint8_t *dst = rtOutScratch + headerSize;
+      for (size_t i = 0; i < packetSize; i++) dst[i] = scale8(src[i], bri);
+      out = rtOutScratch;
+    }
+    for (size_t c = 0; c < numClients; c++) {
+      if (!clients[c][0]) continue; // dummy/unset IP address
+      if (!rtOutUdp.beginPacket(clients[c], port)) {
+        DEBUG_PRINTLN(F("Realtime WiFiUDP.beginPacket returned an error"));
+        return 1; // borked
       }
-    } break;
+      rtOutUdp.write(out, headerSize + packetSize);
+      if (!rtOutUdp.endPacket()) {
+        DEBUG_PRINTLN(F("Realtime WiFiUDP.endPacket returned an error"));
+        return 1; // borked
+      }
+    }
+    channel += packetSize;
   }
   return 0;
 }
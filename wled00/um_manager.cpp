@@ -6,7 +6,13 @@
 //Usermod Manager internals
 void UsermodManager::setup()             { for (unsigned i = 0; i < numMods; i++) ums[i]->setup(); }
 void UsermodManager::connected()         { for (unsigned i = 0; i < numMods; i++) ums[i]->connected(); }
-void UsermodManager::loop()              { for (unsigned i = 0; i < numMods; i++) ums[i]->loop();  }
+void UsermodManager::loop() {
+  for (unsigned i = 0; i < numMods; i++) {
+    unsigned long start = micros();
+    ums[i]->loop();
+    PerfMonitor::usermod[i].add(micros() - start);
+  }
+}
 void UsermodManager::handleOverlayDraw() { for (unsigned i = 0; i < numMods; i++) ums[i]->handleOverlayDraw(); }
 void UsermodManager::appendConfigData(Print& dest)  { for (unsigned i = 0; i < numMods; i++) ums[i]->appendConfigData(dest); }
 bool UsermodManager::handleButton(uint8_t b) {
@@ -150,6 +150,133 @@ bool isAsterisksOnly(const char* str, byte maxLen)
 }
 
 
+/*
+ * JSON document pool
+ * Slot 0 is pDoc (general purpose, locked with requestJSONBufferLock()), it is used for anything changing state.
+ * Other slots are used for serializing responses which may take long to send (slow clients), so that they
+ * do not block state changes and presets. If all response slots are in use (or there are none) pDoc is used.
+ * With PSRAM response documents are allocated at boot, otherwise they are allocated with requested size
+ * when needed (if enough heap is left for web server) and freed when released.
+ * Serializing into a response document does not exclude state changes, use StateLock.
+ */
+#define JSON_DOC_POOL_SIZE (1 + JSON_DOC_SERVE_SLOTS)
+#define JSON_DOC_TIMEOUT   250 // ms
+
+typedef struct JsonDocSlot {
+  JsonDocument    *doc;
+  volatile uint8_t lock;      // module holding slot (0 if free), jsonBufferLock for slot 0
+  bool             temp;      // allocated on demand, freed on release
+  size_t           size;      // capacity of doc (0 if not allocated)
+  uint32_t         locks;     // successful requests
+  uint32_t         fails;     // requests that timed out or failed to allocate
+  uint32_t         waitTotal; // time spent waiting for slot (ms)
+  uint16_t         waitMax;   // ms
+} jsondoc_slot_t;
+
+static jsondoc_slot_t jsonDocPool[JSON_DOC_POOL_SIZE];
+#if JSON_DOC_SERVE_SLOTS > 0
+static portMUX_TYPE jsonDocPoolMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+static void addJSONDocWait(jsondoc_slot_t &slot, unsigned long start) {
+  unsigned long wait = millis() - start;
+  slot.locks++;
+  slot.waitTotal += wait;
+  if (wait > slot.waitMax) slot.waitMax = wait;
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static SemaphoreHandle_t stateMutex = xSemaphoreCreateRecursiveMutex();
+void lockState()   { xSemaphoreTakeRecursive(stateMutex, portMAX_DELAY); }
+void unlockState() { xSemaphoreGiveRecursive(stateMutex); }
+#endif
+
+// call after pDoc has been allocated
+void initJSONDocPool() {
+  jsonDocPool[0].doc  = pDoc;
+  jsonDocPool[0].size = pDoc ? pDoc->capacity() : 0;
+  #if JSON_DOC_SERVE_SLOTS > 0
+  if (!(psramSafe && psramFound())) return; // documents are allocated on demand
+  for (unsigned i = 1; i <= JSON_DOC_SERVE_SLOTS; i++) {
+    JsonDocument *doc = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+    if (!doc || doc->capacity() == 0) { delete doc; break; }
+    jsonDocPool[i].doc  = doc;
+    jsonDocPool[i].size = doc->capacity();
+    DEBUG_PRINTF_P(PSTR("JSON response buffer %u allocated: %u\n"), i, JSON_BUFFER_SIZE);
+  }
+  #endif
+}
+
+// returns a cleared JSON document (of at least size bytes for JSON_DOC_SERVE) or nullptr if none could be locked in time
+// document must be returned using releaseJSONDoc()
+JsonDocument *requestJSONDoc(uint8_t module, uint8_t purpose, size_t size) {
+  #if JSON_DOC_SERVE_SLOTS > 0
+  if (purpose == JSON_DOC_SERVE) {
+    unsigned long start = millis();
+    jsondoc_slot_t *busy = nullptr; // last response slot held by another request
+    do {
+      busy = nullptr;
+      for (unsigned i = 1; i < JSON_DOC_POOL_SIZE; i++) {
+        jsondoc_slot_t &slot = jsonDocPool[i];
+        bool locked = false;
+        portENTER_CRITICAL(&jsonDocPoolMux);
+        if (!slot.lock) { slot.lock = module ? module : 255; locked = true; }
+        portEXIT_CRITICAL(&jsonDocPoolMux);
+        if (!locked) { busy = &slot; continue; } // may be released soon
+        if (slot.doc && slot.size < size) { slot.lock = 0; continue; } // too small for this response
+        if (!slot.doc) {
+          if (ESP.getMaxAllocHeap() >= size + MIN_HEAP_SIZE) { // keep heap for web server
+            slot.doc = new PSRAMDynamicJsonDocument(size);
+            if (slot.doc && slot.doc->capacity() == 0) { delete slot.doc; slot.doc = nullptr; }
+          }
+          slot.temp = slot.doc != nullptr;
+          slot.size = slot.doc ? slot.doc->capacity() : 0;
+          if (!slot.doc) { slot.fails++; slot.lock = 0; continue; } // allocation failed
+        }
+        addJSONDocWait(slot, start);
+        slot.doc->clear();
+        return slot.doc;
+      }
+      if (!busy || jsonBufferLock == 0) break; // no response slots or pDoc is free
+      delay(1);
+    } while (millis() - start < JSON_DOC_TIMEOUT);
+    if (busy && millis() - start >= JSON_DOC_TIMEOUT) busy->fails++; // timed out waiting
+  }
+  #endif
+  return requestJSONBufferLock(module) ? pDoc : nullptr;
+}
+
+void releaseJSONDoc(JsonDocument *doc) {
+  for (unsigned i = 1; i < JSON_DOC_POOL_SIZE; i++) {
+    if (jsonDocPool[i].doc == doc) {
+      if (jsonDocPool[i].temp) {
+        delete doc;
+        jsonDocPool[i].doc  = nullptr;
+        jsonDocPool[i].temp = false;
+        jsonDocPool[i].size = 0;
+      }
+      jsonDocPool[i].lock = 0;
+      return;
+    }
+  }
+  releaseJSONBufferLock();
+}
+
+// pool statistics for /json/info
+void serializeJSONDocPool(JsonArray arr) {
+  jsonDocPool[0].lock = jsonBufferLock;
+  for (const auto &slot : jsonDocPool) {
+    if (!slot.doc && !slot.locks) continue;
+    JsonObject s = arr.createNestedObject();
+    s["s"] = slot.size; // 0 if allocated on demand and not in use
+    s["l"] = slot.lock;        // module holding the slot
+    s["n"] = slot.locks;
+    s["f"] = slot.fails;
+    s["w"] = slot.locks ? slot.waitTotal / slot.locks : 0; // average wait (ms)
+    s[F("wm")] = slot.waitMax;
+  }
+}
+
 //threading/network callback details: https://github.com/Aircoookie/WLED/pull/2336#discussion_r762276994
 bool requestJSONBufferLock(uint8_t module)
 {
@@ -157,18 +284,19 @@ bool requestJSONBufferLock(uint8_t module)
     DEBUG_PRINTLN(F("ERROR: JSON buffer not allocated!"));
     return false;
   }
+  unsigned long start = millis();
 
 #if defined(ARDUINO_ARCH_ESP32)
   // Use a recursive mutex type in case our task is the one holding the JSON buffer.
   // This can happen during large JSON web transactions.  In this case, we continue immediately
   // and then will return out below if the lock is still held.
-  if (xSemaphoreTakeRecursive(jsonBufferLockMutex, 250) == pdFALSE) return false;  // timed out waiting
+  if (xSemaphoreTakeRecursive(jsonBufferLockMutex, JSON_DOC_TIMEOUT) == pdFALSE) { jsonDocPool[0].fails++; return false; } // timed out waiting
 #elif defined(ARDUINO_ARCH_ESP8266)
   // If we're in system context, delay() won't return control to the user context, so there's
   // no point in waiting.
   if (can_yield()) {
     unsigned long now = millis();
-    while (jsonBufferLock && (millis()-now < 250)) delay(1); // wait for fraction for buffer lock
+    while (jsonBufferLock && (millis()-now < JSON_DOC_TIMEOUT)) delay(1); // wait for fraction for buffer lock
   }
 #else
   #error Unsupported task framework - fix requestJSONBufferLock
@@ -176,6 +304,7 @@ bool requestJSONBufferLock(uint8_t module)
   // If the lock is still held - by us, or by another task
   if (jsonBufferLock) {
     DEBUG_PRINTF_P(PSTR("ERROR: Locking JSON buffer (%d) failed! (still locked by %d)\n"), module, jsonBufferLock);
+    jsonDocPool[0].fails++;
 #ifdef ARDUINO_ARCH_ESP32
     xSemaphoreGiveRecursive(jsonBufferLockMutex);
 #endif
@@ -183,6 +312,7 @@ bool requestJSONBufferLock(uint8_t module)
   }
 
   jsonBufferLock = module ? module : 255;
+  addJSONDocWait(jsonDocPool[0], start);
   DEBUG_PRINTF_P(PSTR("JSON buffer locked. (%d)\n"), jsonBufferLock);
   pDoc->clear();
   return true;
@@ -528,13 +658,16 @@ um_data_t* simulateSound(uint8_t simulationId)
 }
 
 static const char s_ledmap_tmpl[] PROGMEM = "ledmap%d.json";
-// enumerate all ledmapX.json files on FS and extract ledmap names if existing
+static const char s_ledmap_bin_tmpl[] PROGMEM = "ledmap%d.bin";
+// enumerate all ledmapX.json and ledmapX.bin files on FS and extract ledmap names if existing
 void enumerateLedmaps() {
   ledMaps = 1;
   for (size_t i=1; i<WLED_MAX_LEDMAPS; i++) {
     char fileName[33] = "/";
-    sprintf_P(fileName+1, s_ledmap_tmpl, i);
-    bool isFile = WLED_FS.exists(fileName);
+    sprintf_P(fileName+1, s_ledmap_bin_tmpl, i);
+    bool isBin  = WLED_FS.exists(fileName);
+    if (!isBin) sprintf_P(fileName+1, s_ledmap_tmpl, i);
+    bool isFile = isBin || WLED_FS.exists(fileName);
 
     #ifndef ESP8266
     if (ledmapNames[i-1]) { //clear old name
@@ -547,29 +680,28 @@ void enumerateLedmaps() {
       ledMaps |= 1 << i;
 
       #ifndef ESP8266
-      if (requestJSONBufferLock(21)) {
+      char name[33] = "";
+      if (isBin) {
+        // name is stored in binary header, no need for JSON buffer
+        File f = WLED_FS.open(fileName, "r");
+        ledmap_bin_t hdr;
+        readLedmapBinHeader(f, hdr, name, sizeof(name));
+        if (f) f.close();
+      } else if (requestJSONBufferLock(21)) {
         if (readObjectFromFile(fileName, nullptr, pDoc)) {
-          size_t len = 0;
           JsonObject root = pDoc->as<JsonObject>();
           if (!root["n"].isNull()) {
             // name field exists
-            const char *name = root["n"].as<const char*>();
-            if (name != nullptr) len = strlen(name);
-            if (len > 0 && len < 33) {
-              ledmapNames[i-1] = new char[len+1];
-              if (ledmapNames[i-1]) strlcpy(ledmapNames[i-1], name, 33);
-            }
-          }
-          if (!ledmapNames[i-1]) {
-            char tmp[33];
-            snprintf_P(tmp, 32, s_ledmap_tmpl, i);
-            len = strlen(tmp);
-            ledmapNames[i-1] = new char[len+1];
-            if (ledmapNames[i-1]) strlcpy(ledmapNames[i-1], tmp, 33);
+            const char *n = root["n"].as<const char*>();
+            if (n != nullptr && strlen(n) < 33) strlcpy(name, n, sizeof(name));
           }
         }
         releaseJSONBufferLock();
-      }
+      } else continue;
+      if (!name[0]) snprintf_P(name, 32, isBin ? s_ledmap_bin_tmpl : s_ledmap_tmpl, i);
+      size_t len = strlen(name);
+      ledmapNames[i-1] = new char[len+1];
+      if (ledmapNames[i-1]) strlcpy(ledmapNames[i-1], name, len+1);
       #endif
     }
 
@@ -412,6 +412,7 @@ void WLED::setup()
   }
   DEBUG_PRINTF_P(PSTR("TX power: %d/%d\n"), WiFi.getTxPower(), txPower);
 #endif
+  initJSONDocPool();
 
 #ifdef ESP8266
   usePWMFixedNMI(); // link the NMI fix
@@ -445,6 +446,7 @@ void WLED::setup()
 #else
   initPresetsFile();
 #endif
+  initPresetsIndex();
   updateFSInfo();
 
   // generate module IDs must be done before AP setup
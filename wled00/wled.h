@@ -187,6 +187,7 @@ using PSRAMDynamicJsonDocument = BasicJsonDocument<PSRAM_Allocator>;
 #include "pin_manager.h"
 #include "bus_manager.h"
 #include "FX.h"
+#include "perf.h"
 
 #ifndef CLIENT_SSID
   #define CLIENT_SSID DEFAULT_CLIENT_SSID
@@ -395,6 +396,11 @@ WLED_GLOBAL bool useGlobalLedBuffer _INIT(false); // double buffering disabled o
 #else
 WLED_GLOBAL bool useGlobalLedBuffer _INIT(true);  // double buffering enabled on ESP32
 #endif
+#ifdef WLED_DISABLE_SEGMENT_BUFFERS
+WLED_GLOBAL bool useSegmentBuffers _INIT(false); // segments draw directly to busses
+#else
+WLED_GLOBAL bool useSegmentBuffers _INIT(true);  // per segment pixel buffers for compositing
+#endif
 #ifdef WLED_USE_IC_CCT
 WLED_GLOBAL bool cctICused          _INIT(true);  // CCT IC used (Athom 15W bulbs)
 #else
@@ -578,6 +584,7 @@ WLED_GLOBAL byte lastRandomIndex _INIT(0);        // used to save last random co
 // transitions
 WLED_GLOBAL bool          fadeTransition           _INIT(true);   // enable crossfading brightness/color
 WLED_GLOBAL bool          modeBlending             _INIT(true);   // enable effect blending
+WLED_GLOBAL byte          blendingStyle            _INIT(0);      // effect blending style (blendingstyle_t) if both effects have pixel buffers
 WLED_GLOBAL bool          transitionActive         _INIT(false);
 WLED_GLOBAL uint16_t      transitionDelay          _INIT(750);    // global transition duration
 WLED_GLOBAL uint16_t      transitionDelayDefault   _INIT(750);    // default transition time (stored in cfg.json)
@@ -878,6 +885,9 @@ WLED_GLOBAL WiFiUDP ntpUdp;
 WLED_GLOBAL ESPAsyncE131 e131 _INIT_N(((handleE131Packet)));
 WLED_GLOBAL ESPAsyncE131 ddp  _INIT_N(((handleE131Packet)));
 WLED_GLOBAL bool e131NewData _INIT(false);
+WLED_GLOBAL uint32_t realtimeFramesShown   _INIT(0); // E1.31/Art-Net/DDP frames shown
+WLED_GLOBAL uint32_t realtimeFramesPartial _INIT(0); // frames shown before all universes arrived
+WLED_GLOBAL uint32_t realtimePacketsLate   _INIT(0); // packets arriving out of sequence (belonging to an earlier frame)
 
 // led fx library object
 WLED_GLOBAL BusManager busses _INIT(BusManager());
@@ -11,15 +11,340 @@ unsigned long wsLastLiveTime = 0;
 
 #define WS_LIVE_INTERVAL 40
 
+/*
+ * State push
+ * Clients that sent {"dlt":true} (web UI) only receive what changed since their last update:
+ * {"delta":true,"state":{...},"info":{...}} where "state" holds the whole state header if it changed and
+ * only changed segments in "seg" (removed segments as {"id":n,"stop":0}), "info" is included if it changed
+ * (ignoring counters like uptime or free heap) or every WS_INFO_INTERVAL. Other clients receive full state+info.
+ * Changes are found by comparing hashes of each serialized part with the ones last sent to the client.
+ * Updates are coalesced per client: a client with a non-empty send queue or one updated less than
+ * WS_PUSH_INTERVAL ago is updated later from handleWs() with the then current state.
+ * Full snapshots are sent on connect and on {"v":true} requests.
+ * Client table is used by loop() and by the async web server task (WS events), guard it with WsPushLock.
+ */
+#ifdef ESP8266
+#define WS_PUSH_CLIENTS  3      // same as ws.cleanupClients(3)
+#else
+#define WS_PUSH_CLIENTS  8
+#endif
+#define WS_PUSH_INTERVAL 100    // ms, minimum time between updates of a client
+#define WS_INFO_INTERVAL 10000  // ms, unchanged info is still refreshed this often
+
+typedef struct WsPushClient {
+  uint32_t      id;                    // AsyncWebSocketClient id, 0 if slot is free
+  uint32_t      state;                 // hashes of parts last sent to client
+  uint32_t      seg[MAX_NUM_SEGMENTS]; // 0 if segment was not active
+  uint32_t      info;
+  unsigned long lastPush;
+  unsigned long lastInfo;
+  bool          delta;                 // client accepts delta updates
+  bool          pending;               // state changed since last update
+} ws_push_client_t;
+
+typedef struct WsPushParts {
+  String   state;                      // state without segments
+  String   seg[MAX_NUM_SEGMENTS];
+  String   info;
+  uint32_t stateHash;
+  uint32_t segHash[MAX_NUM_SEGMENTS];  // 0 if segment is not active
+  uint32_t infoHash;
+} ws_push_parts_t;
+
+static ws_push_client_t wsPushClients[WS_PUSH_CLIENTS];
+static volatile bool wsPushPending = false;
+
+#ifdef ARDUINO_ARCH_ESP32
+static SemaphoreHandle_t wsPushMutex = xSemaphoreCreateRecursiveMutex();
+class WsPushLock {
+  public:
+    WsPushLock()  { xSemaphoreTakeRecursive(wsPushMutex, portMAX_DELAY); }
+    ~WsPushLock() { xSemaphoreGiveRecursive(wsPushMutex); }
+};
+#else
+// async callbacks do not preempt loop() on ESP8266
+class WsPushLock { public: WsPushLock() {} };
+#endif
+
+// FNV-1a hash of everything printed to it
+class WsHash : public Print {
+  public:
+    uint32_t hash = 2166136261UL;
+    size_t write(uint8_t c) override { hash = (hash ^ c) * 16777619UL; return 1; }
+    using Print::write;
+};
+
+static ws_push_client_t *getWsPushClient(uint32_t id, bool add = false)
+{
+  ws_push_client_t *unused = nullptr;
+  for (auto &pc : wsPushClients) {
+    if (pc.id == id) return &pc;
+    if (!pc.id && !unused) unused = &pc;
+  }
+  if (!add || !unused) return nullptr;
+  memset(unused, 0, sizeof(ws_push_client_t));
+  unused->id = id;
+  return unused;
+}
+
+// serializes state header, segments and info into doc, returns false if a part did not fit
+static bool fillWsParts(JsonDocument &doc, ws_push_parts_t &parts)
+{
+  serializeStateHeader(doc.to<JsonObject>());
+  if (doc.overflowed()) return false;
+  parts.state = "";
+  serializeJson(doc, parts.state);
+  WsHash stateHash;
+  stateHash.print(parts.state);
+  parts.stateHash = stateHash.hash;
+
+  for (size_t s = 0; s < MAX_NUM_SEGMENTS; s++) {
+    parts.segHash[s] = 0;
+    if (s >= strip.getSegmentsNum() || !strip.getSegment(s).isActive()) continue;
+    JsonObject seg = doc.to<JsonObject>();
+    serializeSegment(seg, strip.getSegment(s), s);
+    if (doc.overflowed()) return false;
+    parts.seg[s] = "";
+    serializeJson(doc, parts.seg[s]);
+    WsHash segHash;
+    segHash.print(parts.seg[s]);
+    parts.segHash[s] = segHash.hash ? segHash.hash : 1;
+  }
+
+  JsonObject info = doc.to<JsonObject>();
+  serializeInfo(info);
+  if (doc.overflowed()) return false;
+  parts.info = "";
+  serializeJson(doc, parts.info);
+  // ignore values changing all the time when looking for changes
+  static const char *volatileInfo[] = {"uptime", "freeheap", "psram", "time", "ws", "wifi", "lfr", "perf", "jdoc"};
+  for (const char *key : volatileInfo) info.remove(key);
+  JsonObject leds = info["leds"];
+  leds.remove("pwr");
+  leds.remove("fps");
+  leds.remove("fxdata");
+  WsHash infoHash;
+  serializeJson(doc, infoHash);
+  parts.infoHash = infoHash.hash;
+  return true;
+}
+
+// returns false if no JSON buffer is available or parts do not fit into the largest one
+static bool serializeWsParts(ws_push_parts_t &parts)
+{
+  JsonDocument *doc = requestJSONDoc(12, JSON_DOC_SERVE, JSON_DOC_SERVE_SMALL);
+  if (!doc) return false;
+  bool ok;
+  {
+    StateLock stateLock; // segments may be changed by other task
+    ok = fillWsParts(*doc, parts);
+  }
+  if (!ok && doc->capacity() < JSON_BUFFER_SIZE) {
+    // many segments do not fit into a small document, retry with a full size one
+    DEBUG_PRINTF_P(PSTR("WS: parts do not fit into %u bytes.\n"), (unsigned)doc->capacity());
+    releaseJSONDoc(doc); // request documents without holding the state lock
+    doc = requestJSONDoc(12, JSON_DOC_SERVE, JSON_BUFFER_SIZE);
+    if (!doc) return false;
+    StateLock stateLock;
+    ok = fillWsParts(*doc, parts);
+  }
+  releaseJSONDoc(doc);
+  return ok;
+}
+
+// writes full or delta message for client into buf and returns its length (only length if buf is nullptr)
+static size_t composeWsMessage(char *buf, const ws_push_parts_t &parts, const ws_push_client_t *pc, bool withInfo)
+{
+  size_t len = 0;
+  auto put = [&](const char *str, size_t n) { if (buf) memcpy(buf + len, str, n); len += n; };
+  const String &state = parts.state; // {...} without segments
+
+  if (!pc || !pc->delta) {
+    put("{\"state\":", 9);
+    put(state.c_str(), state.length() - 1);
+    put(",\"seg\":[", 8);
+    bool first = true;
+    for (size_t s = 0; s < MAX_NUM_SEGMENTS; s++) {
+      if (!parts.segHash[s]) continue;
+      if (!first) put(",", 1);
+      put(parts.seg[s].c_str(), parts.seg[s].length());
+      first = false;
+    }
+    put("]},\"info\":", 10);
+    put(parts.info.c_str(), parts.info.length());
+    put("}", 1);
+    return len;
+  }
+
+  put("{\"delta\":true", 13);
+  bool stateChanged = parts.stateHash != pc->state;
+  bool segChanged = false;
+  for (size_t s = 0; s < MAX_NUM_SEGMENTS; s++) segChanged |= parts.segHash[s] != pc->seg[s];
+  if (stateChanged || segChanged) {
+    put(",\"state\":{", 10);
+    if (stateChanged) {
+      put(state.c_str() + 1, state.length() - 2);
+      put(",", 1);
+    }
+    put("\"seg\":[", 7);
+    bool first = true;
+    for (size_t s = 0; s < MAX_NUM_SEGMENTS; s++) {
+      if (parts.segHash[s] == pc->seg[s]) continue;
+      if (!first) put(",", 1);
+      if (parts.segHash[s]) put(parts.seg[s].c_str(), parts.seg[s].length());
+      else {
+        char removed[24];
+        put(removed, sprintf_P(removed, PSTR("{\"id\":%u,\"stop\":0}"), (unsigned)s));
+      }
+      first = false;
+    }
+    put("]}", 2);
+  }
+  if (withInfo) {
+    put(",\"info\":", 8);
+    put(parts.info.c_str(), parts.info.length());
+  }
+  put("}", 1);
+  return len;
+}
+
+// sends message to a single client (or all clients if client is nullptr)
+static bool sendWsMessage(AsyncWebSocketClient *client, const ws_push_parts_t &parts, ws_push_client_t *pc, bool withInfo)
+{
+  size_t len = composeWsMessage(nullptr, parts, pc, withInfo);
+
+  // the following may no longer be necessary as heap management has been fixed by @willmmiles in AWS
+  size_t heap1 = ESP.getFreeHeap();
+  DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
+  #ifdef ESP8266
+  if (len>heap1) {
+    DEBUG_PRINTLN(F("Out of memory (WS)!"));
+    return false;
+  }
+  #endif
+  AsyncWebSocketBuffer buffer(len);
+  #ifdef ESP8266
+  size_t heap2 = ESP.getFreeHeap();
+  DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
+  #else
+  size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
+  #endif
+  if (!buffer || heap1-heap2<len) {
+    DEBUG_PRINTLN(F("WS buffer allocation failed."));
+    ws.closeAll(1013); //code 1013 = temporary overload, try again later
+    ws.cleanupClients(0); //disconnect all clients to release memory
+    return false; //out of memory
+  }
+  composeWsMessage((char *)buffer.data(), parts, pc, withInfo);
+
+  DEBUG_PRINTF_P(PSTR("Sending WS %s (%u)\n"), pc && pc->delta ? "delta" : "data", len);
+  if (client) client->text(std::move(buffer));
+  else        ws.textAll(std::move(buffer));
+  return true;
+}
+
+// client has pending changes and may be updated now
+static bool isWsPushDue(const ws_push_client_t &pc, AsyncWebSocketClient *client)
+{
+  return pc.pending && client && millis() - pc.lastPush >= WS_PUSH_INTERVAL && client->queueLength() == 0;
+}
+
+static void updateWsPushClient(ws_push_client_t &pc, const ws_push_parts_t &parts, bool withInfo)
+{
+  pc.state = parts.stateHash;
+  memcpy(pc.seg, parts.segHash, sizeof(pc.seg));
+  if (withInfo) {
+    pc.info = parts.infoHash;
+    pc.lastInfo = millis();
+  }
+  pc.lastPush = millis();
+  pc.pending = false;
+}
+
+// updates clients with pending changes which are ready to receive them (or only the given one with a full snapshot)
+static void pushWsState(AsyncWebSocketClient *single = nullptr)
+{
+  WsPushLock lock;
+  // clients without a slot can only be updated with full broadcasts
+  unsigned tracked = 0;
+  bool pending = false;
+  bool due = false;
+  for (auto &pc : wsPushClients) {
+    if (!pc.id) continue;
+    AsyncWebSocketClient *client = ws.client(pc.id);
+    if (!client) {
+      pc.id = 0; // disconnected
+      continue;
+    }
+    tracked++;
+    pending |= pc.pending;
+    due |= isWsPushDue(pc, client);
+  }
+  bool broadcast = !single && ws.count() > tracked;
+  if (!single && !broadcast && !due) {
+    wsPushPending = pending; // nothing to send yet
+    return;
+  }
+
+  ws_push_parts_t *parts = new ws_push_parts_t();
+  if (!parts || !serializeWsParts(*parts)) {
+    delete parts;
+    const char* error = PSTR("{\"error\":3}");
+    if (single) {
+      single->text(FPSTR(error)); // ERR_NOBUF
+      return;
+    }
+    ws.textAll(FPSTR(error)); // ERR_NOBUF
+    for (auto &pc : wsPushClients) pc.pending = false;
+    wsPushPending = false;
+    return;
+  }
+
+  if (single) {
+    ws_push_client_t *pc = getWsPushClient(single->id());
+    if (sendWsMessage(single, *parts, nullptr, true) && pc) updateWsPushClient(*pc, *parts, true);
+    delete parts;
+    return;
+  }
+
+  if (broadcast) {
+    if (sendWsMessage(nullptr, *parts, nullptr, true)) {
+      for (auto &pc : wsPushClients) if (pc.id) updateWsPushClient(pc, *parts, true);
+    }
+    wsPushPending = false;
+    delete parts;
+    return;
+  }
+
+  wsPushPending = false;
+  for (auto &pc : wsPushClients) {
+    if (!pc.id || !pc.pending) continue;
+    AsyncWebSocketClient *client = ws.client(pc.id);
+    if (!isWsPushDue(pc, client)) {
+      wsPushPending = true; // coalesce with later changes
+      continue;
+    }
+    bool withInfo = !pc.delta || parts->infoHash != pc.info || millis() - pc.lastInfo > WS_INFO_INTERVAL;
+    if (!sendWsMessage(client, *parts, &pc, withInfo)) break;
+    updateWsPushClient(pc, *parts, withInfo);
+  }
+  delete parts;
+}
+
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
   if(type == WS_EVT_CONNECT){
     //client connected
     DEBUG_PRINTLN(F("WS client connected."));
+    WsPushLock lock; // snapshot must not be mixed with updates from loop()
+    getWsPushClient(client->id(), true);
     sendDataWs(client);
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    WsPushLock lock;
+    ws_push_client_t *pc = getWsPushClient(client->id());
+    if (pc) pc->id = 0;
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
@@ -47,6 +372,15 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           releaseJSONBufferLock();
           return;
         }
+        if (root.containsKey(F("dlt")) && root.size() == 1) {
+          // client accepts delta updates, no response needed
+          bool delta = root[F("dlt")];
+          releaseJSONBufferLock(); // before taking WsPushLock, pushWsState() requests JSON buffer while holding it
+          WsPushLock lock;
+          ws_push_client_t *pc = getWsPushClient(client->id());
+          if (pc) pc->delta = delta;
+          return;
+        }
         if (root["v"] && root.size() == 1) {
           //if the received value is just "{"v":true}", send only to this client
           verboseResponse = true;
@@ -105,59 +439,14 @@ void sendDataWs(AsyncWebSocketClient * client)
 {
   if (!ws.count()) return;
 
-  if (!requestJSONBufferLock(12)) {
-    const char* error = PSTR("{\"error\":3}");
-    if (client) {
-      client->text(FPSTR(error)); // ERR_NOBUF
-    } else {
-      ws.textAll(FPSTR(error)); // ERR_NOBUF
-    }
-    return;
-  }
-
-  JsonObject state = pDoc->createNestedObject("state");
-  serializeState(state);
-  JsonObject info  = pDoc->createNestedObject("info");
-  serializeInfo(info);
-
-  size_t len = measureJson(*pDoc);
-  DEBUG_PRINTF_P(PSTR("JSON buffer size: %u for WS request (%u).\n"), pDoc->memoryUsage(), len);
-
-  // the following may no longer be necessary as heap management has been fixed by @willmmiles in AWS
-  size_t heap1 = ESP.getFreeHeap();
-  DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
-  #ifdef ESP8266
-  if (len>heap1) {
-    DEBUG_PRINTLN(F("Out of memory (WS)!"));
-    return;
-  }
-  #endif
-  AsyncWebSocketBuffer buffer(len);
-  #ifdef ESP8266
-  size_t heap2 = ESP.getFreeHeap();
-  DEBUG_PRINTF_P(PSTR("heap %u\n"), ESP.getFreeHeap());
-  #else
-  size_t heap2 = 0; // ESP32 variants do not have the same issue and will work without checking heap allocation
-  #endif
-  if (!buffer || heap1-heap2<len) {
-    releaseJSONBufferLock();
-    DEBUG_PRINTLN(F("WS buffer allocation failed."));
-    ws.closeAll(1013); //code 1013 = temporary overload, try again later
-    ws.cleanupClients(0); //disconnect all clients to release memory
-    return; //out of memory
-  }
-  serializeJson(*pDoc, (char *)buffer.data(), len);
-
-  DEBUG_PRINT(F("Sending WS data "));
   if (client) {
-    DEBUG_PRINTLN(F("to a single client."));
-    client->text(std::move(buffer));
-  } else {
-    DEBUG_PRINTLN(F("to multiple clients."));
-    ws.textAll(std::move(buffer));
+    pushWsState(client);
+    return;
   }
-
-  releaseJSONBufferLock();
+  WsPushLock lock;
+  for (auto &pc : wsPushClients) pc.pending = pc.id;
+  wsPushPending = true;
+  pushWsState();
 }
 
 bool sendLiveLedsWs(uint32_t wsClient)
@@ -233,6 +522,7 @@ void handleWs()
     wsLastLiveTime = millis();
     if (!success) wsLastLiveTime -= 20; //try again in 20ms if failed due to non-empty WS queue
   }
+  if (wsPushPending) pushWsState(); // coalesced updates of busy clients
 }
 
 #else
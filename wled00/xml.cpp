@@ -289,6 +289,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     printSetFormValue(settingsScript,PSTR("FR"),strip.getTargetFps());
     printSetFormValue(settingsScript,PSTR("AW"),Bus::getGlobalAWMode());
     printSetFormCheckbox(settingsScript,PSTR("LD"),useGlobalLedBuffer);
+    printSetFormCheckbox(settingsScript,PSTR("SB"),useSegmentBuffers);
 
     unsigned sumMa = 0;
     for (int s = 0; s < BusManager::getNumBusses(); s++) {
@@ -308,6 +309,8 @@ void getSettingsJS(byte subPage, Print& settingsScript)
       char sp[4] = "SP"; sp[2] = offset+s; sp[3] = 0; //bus clock speed
       char la[4] = "LA"; la[2] = offset+s; la[3] = 0; //LED current
       char ma[4] = "MA"; ma[2] = offset+s; ma[3] = 0; //max per-port PSU current
+      char no[4] = "NO"; no[2] = offset+s; no[3] = 0; //network start universe/channel
+      char nd[4] = "ND"; nd[2] = offset+s; nd[3] = 0; //network additional receivers
       settingsScript.print(F("addLEDs(1);"));
       uint8_t pins[5];
       int nPins = bus->getPins(pins);
@@ -345,6 +348,17 @@ void getSettingsJS(byte subPage, Print& settingsScript)
         }
       }
       printSetFormValue(settingsScript,sp,speed);
+      if (bus->isVirtual()) {
+        printSetFormValue(settingsScript,no,bus->getFrequency());
+        IPAddress dests[WLED_MAX_NET_DESTINATIONS];
+        unsigned numDests = static_cast<BusNetwork*>(bus)->getDestinations(dests);
+        String destList;
+        for (unsigned i = 0; i < numDests; i++) {
+          if (i) destList += ',';
+          destList += dests[i].toString();
+        }
+        printSetFormValue(settingsScript,nd,destList.c_str());
+      }
       printSetFormValue(settingsScript,la,bus->getLEDCurrent());
       printSetFormValue(settingsScript,ma,bus->getMaxCurrent());
       sumMa += bus->getMaxCurrent();
@@ -371,6 +385,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
     dtostrf(gammaCorrectVal,3,1,nS); printSetFormValue(settingsScript,PSTR("GV"),nS);
     printSetFormCheckbox(settingsScript,PSTR("TF"),fadeTransition);
     printSetFormCheckbox(settingsScript,PSTR("EB"),modeBlending);
+    printSetFormValue(settingsScript,PSTR("BS"),blendingStyle);
     printSetFormValue(settingsScript,PSTR("TD"),transitionDelayDefault);
     printSetFormCheckbox(settingsScript,PSTR("PF"),strip.paletteFade);
     printSetFormValue(settingsScript,PSTR("TP"),randomPaletteChangeTime);